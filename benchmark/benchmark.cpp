@@ -0,0 +1,513 @@
+// Benchmark dokładności i wydajności detekcji pików R na bazie LUDB.
+//
+// Dla każdej kombinacji filtra (brak / średnia ruchoma / Butterworth) i detektora
+// (Pan-Tompkins, Hilbert, Wavelet, wieloodprowadzeniowy; pełna rozdzielczość, tryb
+// wielorozdzielczy oraz detektor przyrostowy) przetwarza wszystkie rekordy i porównuje
+// wykryte piki z adnotacjami QRS odprowadzenia II.
+//
+// Użycie: ekg_benchmark [katalog_ludb] [plik_wynikowy.json] [liczba_rekordów]
+//         ekg_benchmark --synthetic [liczba_godzin] [częstotliwość] [plik_wynikowy.json]
+//
+// Tryb --synthetic zamiast LUDB przetwarza jeden długi zapis z SyntheticSignalRepository
+// (domyślnie 1 h przy 500 Hz, 1% pobudzeń komorowych i nadkomorowych) z dokładnymi adnotacjami R.
+// Zapis jest trzymany w pamięci 16-bitowej i przetwarzany blokami (ok. 2 GB na dobę przy 1 kHz i 12
+// odprowadzeniach), więc mieszczą się także zapisy wielodobowe.
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "ludb_annotations.h"
+#include "../include/repository/dat_signal_repository.h"
+#include "../include/repository/synthetic_signal_repository.h"
+#include "../include/service/butterworth_filter_service.h"
+#include "../include/service/moving_average_filter_service.h"
+#include "../include/service/r_peaks_detection_service.h"
+
+namespace {
+    // Tolerancja dopasowania wykrytego piku do adnotacji (jak w ANSI/AAMI EC57)
+    constexpr double MATCH_TOLERANCE_MS = 150.0;
+
+    // Zapisy w pamięci 16-bitowej (tryb --synthetic) są przetwarzane blokami: blok jest rozwijany do float,
+    // filtrowany i przekazywany detektorowi z marginesem po obu stronach (rozbieg filtru i progów detektora),
+    // a zachowywane są tylko piki z jego środkowej części
+    constexpr double BLOCK_SECONDS = 300.0;
+    constexpr double BLOCK_MARGIN_SECONDS = 5.0;
+
+    enum class DetectionMode {
+        Full,
+        MultiRate,
+        Streaming
+    };
+
+    struct Record {
+        QString name;
+        std::shared_ptr<SignalDataset> dataset;
+        std::vector<long long> reference;
+    };
+
+    struct BenchmarkConfig {
+        QString filter;
+        std::shared_ptr<IFilterService> filter_service;
+        RPeaksDetectionMethod method;
+        DetectionMode mode;
+    };
+
+    struct BenchmarkResult {
+        long long samples = 0;
+        long long tp = 0;
+        long long fp = 0;
+        long long fn = 0;
+        std::vector<double> timing_errors_ms;
+        std::vector<double> latencies_ms;
+        double total_seconds = 0.0;
+        long peak_memory_kb = -1;
+    };
+
+    const char *MethodName(RPeaksDetectionMethod m) {
+        switch (m) {
+            case RPeaksDetectionMethod::PanTompkins: return "PanTompkins";
+            case RPeaksDetectionMethod::Hilbert: return "Hilbert";
+            case RPeaksDetectionMethod::Wavelet: return "Wavelet";
+            case RPeaksDetectionMethod::MultiLead: return "MultiLead";
+            default: return "Unknown";
+        }
+    }
+
+    const char *ModeName(DetectionMode m) {
+        switch (m) {
+            case DetectionMode::Full: return "full";
+            case DetectionMode::MultiRate: return "multirate";
+            case DetectionMode::Streaming: return "streaming";
+            default: return "unknown";
+        }
+    }
+
+    // Usługi drukują komunikaty na std::cout - na czas pomiarów są wyciszane
+    class NullBuffer : public std::streambuf {
+    protected:
+        int overflow(int c) override { return c; }
+    };
+
+    class ScopedSilence {
+        NullBuffer null_;
+        std::streambuf *previous_;
+
+    public:
+        ScopedSilence() : previous_(std::cout.rdbuf(&null_)) {
+        }
+
+        ~ScopedSilence() { std::cout.rdbuf(previous_); }
+    };
+
+#ifdef __linux__
+    long ReadStatusKb(const char *key) {
+        std::ifstream status("/proc/self/status");
+        std::string line;
+        const std::string prefix = std::string(key) + ":";
+        while (std::getline(status, line)) {
+            if (line.compare(0, prefix.size(), prefix) == 0)
+                return std::stol(line.substr(prefix.size()));
+        }
+        return -1;
+    }
+
+    // Zerowanie VmHWM, żeby szczyt pamięci był mierzony osobno dla każdej konfiguracji
+    void ResetPeakMemory() {
+        std::ofstream("/proc/self/clear_refs") << "5";
+    }
+#else
+    long ReadStatusKb(const char *) { return -1; }
+
+    void ResetPeakMemory() {
+    }
+#endif
+
+    double Percentile(std::vector<double> values, double p) {
+        if (values.empty()) return 0.0;
+        size_t idx = static_cast<size_t>(p * (values.size() - 1));
+        std::nth_element(values.begin(), values.begin() + idx, values.end());
+        return values[idx];
+    }
+
+    std::vector<long long> PeakIndices(const std::vector<RPeaksAnnotatedSignalDatapoint> &annotated) {
+        std::vector<long long> peaks;
+        for (size_t i = 0; i < annotated.size(); ++i)
+            if (annotated[i].peak) peaks.push_back(static_cast<long long>(i));
+        return peaks;
+    }
+
+    // Próbki [from, to) sygnału do detektora przyrostowego w blokach po 1 s, jak przy monitorowaniu na żywo
+    void PushSeconds(IStreamingRPeaksDetector &streaming,
+                     const std::vector<SignalDatapoint> &signal,
+                     size_t from,
+                     size_t to,
+                     int frequency,
+                     std::vector<long long> &peaks) {
+        for (size_t start = from; start < to; start += frequency) {
+            const size_t end = std::min(to, start + static_cast<size_t>(frequency));
+            std::vector<SignalDatapoint> block(signal.begin() + start, signal.begin() + end);
+            for (int64_t p: streaming.Push(block)) peaks.push_back(p);
+        }
+    }
+
+    std::vector<long long> RunDetection(const BenchmarkConfig &config,
+                                        RPeaksDetectionService &detector,
+                                        const std::vector<SignalDatapoint> &signal,
+                                        int frequency) {
+        switch (config.mode) {
+            case DetectionMode::MultiRate:
+                return PeakIndices(detector.DetectMultiRate(signal, frequency, config.method));
+            case DetectionMode::Streaming: {
+                auto streaming = detector.CreateStreamingDetector(frequency);
+                std::vector<long long> peaks;
+                PushSeconds(*streaming, signal, 0, signal.size(), frequency, peaks);
+                for (int64_t p: streaming->Flush()) peaks.push_back(p);
+                return peaks;
+            }
+            case DetectionMode::Full:
+            default:
+                return PeakIndices(detector.Detect(signal, frequency, config.method));
+        }
+    }
+
+    // Dopasowanie wykrytych pików do adnotacji. LUDB nie opisuje uderzeń przy brzegach
+    // nagrania, więc detekcje poza zakresem adnotacji (z tolerancją) są pomijane.
+    void Score(const std::vector<long long> &reference,
+               std::vector<long long> detected,
+               int frequency,
+               BenchmarkResult &result) {
+        const long long tolerance = static_cast<long long>(MATCH_TOLERANCE_MS * frequency / 1000.0);
+        std::sort(detected.begin(), detected.end());
+
+        if (reference.empty()) {
+            result.fp += static_cast<long long>(detected.size());
+            return;
+        }
+
+        const long long lo = reference.front() - tolerance;
+        const long long hi = reference.back() + tolerance;
+        detected.erase(std::remove_if(detected.begin(), detected.end(),
+                                      [&](long long d) { return d < lo || d > hi; }),
+                       detected.end());
+
+        size_t j = 0;
+        for (long long r: reference) {
+            while (j < detected.size() && detected[j] < r - tolerance) {
+                ++result.fp;
+                ++j;
+            }
+            if (j < detected.size() && detected[j] <= r + tolerance) {
+                // Jeśli następna detekcja też mieści się w oknie i jest bliżej, poprzednia jest fałszywa
+                if (j + 1 < detected.size() && detected[j + 1] <= r + tolerance &&
+                    std::llabs(detected[j + 1] - r) < std::llabs(detected[j] - r)) {
+                    ++result.fp;
+                    ++j;
+                }
+                ++result.tp;
+                result.timing_errors_ms.push_back(std::llabs(detected[j] - r) * 1000.0 / frequency);
+                ++j;
+            } else {
+                ++result.fn;
+            }
+        }
+        result.fp += static_cast<long long>(detected.size() - j);
+    }
+
+    // Filtracja i detekcja zapisu w pamięci 16-bitowej blok po bloku - w pamięci jest naraz tylko jeden
+    // rozwinięty blok z marginesami (kilkaset MB zamiast kilkunastu GB dla doby przy 1 kHz)
+    std::vector<long long> RunBlocked(const BenchmarkConfig &config,
+                                      RPeaksDetectionService &detector,
+                                      const SignalDataset &dataset) {
+        const int frequency = dataset.frequency;
+        const size_t n = dataset.Size();
+        const size_t block = static_cast<size_t>(BLOCK_SECONDS * frequency);
+        const size_t margin = static_cast<size_t>(BLOCK_MARGIN_SECONDS * frequency);
+
+        // Detektor przyrostowy jest jeden dla całego zapisu i dostaje kolejne środkowe części bloków
+        std::unique_ptr<IStreamingRPeaksDetector> streaming;
+        if (config.mode == DetectionMode::Streaming) streaming = detector.CreateStreamingDetector(frequency);
+
+        std::vector<long long> peaks;
+        for (size_t from = 0; from < n; from += block) {
+            const size_t to = std::min(n, from + block);
+            const size_t lo = from > margin ? from - margin : 0;
+            const size_t hi = std::min(n, to + margin);
+
+            std::vector<SignalDatapoint> samples = dataset.Samples(lo, hi - lo);
+            if (config.filter_service) samples = config.filter_service->Filter(samples);
+
+            if (streaming) {
+                std::vector<long long> block_peaks;
+                PushSeconds(*streaming, samples, from - lo, to - lo, frequency, block_peaks);
+                peaks.insert(peaks.end(), block_peaks.begin(), block_peaks.end());
+                continue;
+            }
+            for (long long p: RunDetection(config, detector, samples, frequency)) {
+                p += static_cast<long long>(lo);
+                if (p >= static_cast<long long>(from) && p < static_cast<long long>(to)) peaks.push_back(p);
+            }
+        }
+        if (streaming)
+            for (int64_t p: streaming->Flush()) peaks.push_back(p);
+        return peaks;
+    }
+
+    BenchmarkResult RunConfig(const BenchmarkConfig &config, const std::vector<Record> &records) {
+        BenchmarkResult result;
+        RPeaksDetectionService detector(false);
+
+        ResetPeakMemory();
+        const long rss_before = ReadStatusKb("VmRSS");
+
+        for (const auto &record: records) {
+            const auto &values = record.dataset->values;
+            const int frequency = record.dataset->frequency;
+
+            std::vector<long long> detected;
+            const auto start = std::chrono::steady_clock::now();
+            {
+                ScopedSilence silence;
+                if (record.dataset->compact) {
+                    detected = RunBlocked(config, detector, *record.dataset);
+                } else if (config.filter_service) {
+                    const auto filtered = config.filter_service->Filter(values);
+                    detected = RunDetection(config, detector, filtered, frequency);
+                } else {
+                    detected = RunDetection(config, detector, values, frequency);
+                }
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+            result.total_seconds += seconds;
+            result.latencies_ms.push_back(seconds * 1000.0);
+            result.samples += static_cast<long long>(record.dataset->Size());
+
+            Score(record.reference, detected, frequency, result);
+        }
+
+        const long peak = ReadStatusKb("VmHWM");
+        if (peak >= 0 && rss_before >= 0)
+            result.peak_memory_kb = std::max(0L, peak - rss_before);
+
+        return result;
+    }
+
+    QString FindLudbDirectory() {
+        QDir dir(QDir::currentPath());
+        while (!dir.exists("ludb") && dir.cdUp()) {
+        }
+        if (dir.exists("ludb")) return dir.absoluteFilePath("ludb");
+
+        dir = QDir(QCoreApplication::applicationDirPath());
+        while (!dir.exists("ludb") && dir.cdUp()) {
+        }
+        return dir.absoluteFilePath("ludb");
+    }
+
+    std::vector<Record> LoadRecords(const QString &ludb_path, int max_records) {
+        QDir dir(ludb_path);
+        QStringList headers = dir.entryList({"*.hea"}, QDir::Files);
+        std::sort(headers.begin(), headers.end(), [](const QString &a, const QString &b) {
+            return a.section('.', 0, 0).toInt() < b.section('.', 0, 0).toInt();
+        });
+
+        DATSignalRepository repository;
+        std::vector<Record> records;
+        for (const QString &header: headers) {
+            if (max_records > 0 && static_cast<int>(records.size()) >= max_records) break;
+
+            const QString name = header.section('.', 0, 0);
+            Record record;
+            record.name = name;
+            {
+                ScopedSilence silence;
+                record.dataset = repository.Load(dir.absoluteFilePath(name + ".dat"));
+            }
+            if (!record.dataset || record.dataset->values.empty() ||
+                record.dataset->values[0].channelValues.size() < 2) {
+                std::cerr << "Skipping record " << name.toStdString() << std::endl;
+                continue;
+            }
+            record.reference = LoadQrsAnnotations(dir.absoluteFilePath(name + ".ii"));
+            records.push_back(std::move(record));
+        }
+        return records;
+    }
+
+    std::vector<Record> LoadSyntheticRecords(double hours, int frequency) {
+        SyntheticECGOptions options;
+        options.frequency = frequency;
+        options.duration_seconds = hours * 3600.0;
+        options.ventricular_ectopy = 0.01;
+        options.supraventricular_ectopy = 0.01;
+
+        SyntheticSignalRepository repository(options, SampleStorage::Int16);
+        Record record;
+        record.name = "synthetic";
+        {
+            ScopedSilence silence;
+            record.dataset = repository.Load(record.name);
+        }
+        if (!record.dataset || record.dataset->Size() == 0) return {};
+        for (const auto &beat: repository.GetBeats()) record.reference.push_back(beat.r_peak);
+
+        std::vector<Record> records;
+        records.push_back(std::move(record));
+        return records;
+    }
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    const bool synthetic = argc > 1 && std::string(argv[1]) == "--synthetic";
+    QString ludb_path;
+    QString output_path;
+    std::vector<Record> records;
+    if (synthetic) {
+        const double hours = argc > 2 ? std::atof(argv[2]) : 1.0;
+        const int frequency = argc > 3 ? std::atoi(argv[3]) : 500;
+        output_path = argc > 4 ? QString::fromLocal8Bit(argv[4]) : QString("benchmark_results.json");
+
+        records = LoadSyntheticRecords(hours, frequency);
+        if (records.empty()) {
+            std::cerr << "Error: cannot generate synthetic record (" << hours << " h, " << frequency << " Hz)"
+                    << std::endl;
+            return 1;
+        }
+        std::cerr << "Generated synthetic record: " << records[0].dataset->Size() << " samples at "
+                << frequency << " Hz, " << records[0].reference.size() << " beats" << std::endl;
+    } else {
+        ludb_path = argc > 1 ? QString::fromLocal8Bit(argv[1]) : FindLudbDirectory();
+        output_path = argc > 2 ? QString::fromLocal8Bit(argv[2]) : QString("benchmark_results.json");
+        const int max_records = argc > 3 ? std::atoi(argv[3]) : 0;
+
+        records = LoadRecords(ludb_path, max_records);
+        if (records.empty()) {
+            std::cerr << "Error: no LUDB records found in " << ludb_path.toStdString() << std::endl;
+            return 1;
+        }
+        std::cerr << "Loaded " << records.size() << " records from " << ludb_path.toStdString() << std::endl;
+    }
+
+    // Rekordy mają wspólną częstotliwość próbkowania (LUDB - 500 Hz, tryb --synthetic - podana),
+    // a filtr Butterwortha jest projektowany dla niej, bo filtruje bloki próbek bez zbioru danych
+    const std::vector<std::pair<QString, std::shared_ptr<IFilterService> > > filters{
+        {"none", nullptr},
+        {"moving_average", std::make_shared<MovingAverageFilterService>()},
+        {"butterworth", std::make_shared<ButterworthFilterService>(records[0].dataset->frequency)}
+    };
+    const std::vector<RPeaksDetectionMethod> methods{
+        RPeaksDetectionMethod::PanTompkins,
+        RPeaksDetectionMethod::Hilbert,
+        RPeaksDetectionMethod::Wavelet,
+        RPeaksDetectionMethod::MultiLead
+    };
+
+    std::vector<BenchmarkConfig> configs;
+    for (const auto &filter: filters) {
+        for (auto method: methods) {
+            configs.push_back({filter.first, filter.second, method, DetectionMode::Full});
+            configs.push_back({filter.first, filter.second, method, DetectionMode::MultiRate});
+        }
+        // Detektor przyrostowy ma własny filtr pasmowy i zawsze korzysta z odprowadzenia II
+        configs.push_back({filter.first, filter.second, RPeaksDetectionMethod::PanTompkins, DetectionMode::Streaming});
+    }
+
+    QJsonArray results_json;
+
+    std::cout << std::left
+            << std::setw(16) << "filter" << std::setw(13) << "method" << std::setw(11) << "mode"
+            << std::right
+            << std::setw(8) << "Se[%]" << std::setw(8) << "PPV[%]" << std::setw(10) << "err[ms]"
+            << std::setw(14) << "samples/s" << std::setw(10) << "p50[ms]" << std::setw(10) << "p99[ms]"
+            << std::setw(11) << "mem[kB]" << "\n";
+
+    for (const auto &config: configs) {
+        const BenchmarkResult r = RunConfig(config, records);
+
+        const double sensitivity = r.tp + r.fn > 0 ? 100.0 * r.tp / (r.tp + r.fn) : 0.0;
+        const double ppv = r.tp + r.fp > 0 ? 100.0 * r.tp / (r.tp + r.fp) : 0.0;
+        double mean_error = 0.0;
+        for (double e: r.timing_errors_ms) mean_error += e;
+        if (!r.timing_errors_ms.empty()) mean_error /= r.timing_errors_ms.size();
+        const double throughput = r.total_seconds > 0.0 ? r.samples / r.total_seconds : 0.0;
+
+        std::cout << std::left
+                << std::setw(16) << config.filter.toStdString()
+                << std::setw(13) << MethodName(config.method)
+                << std::setw(11) << ModeName(config.mode)
+                << std::right << std::fixed
+                << std::setw(8) << std::setprecision(2) << sensitivity
+                << std::setw(8) << std::setprecision(2) << ppv
+                << std::setw(10) << std::setprecision(1) << mean_error
+                << std::setw(14) << std::setprecision(0) << throughput
+                << std::setw(10) << std::setprecision(3) << Percentile(r.latencies_ms, 0.50)
+                << std::setw(10) << std::setprecision(3) << Percentile(r.latencies_ms, 0.99)
+                << std::setw(11) << r.peak_memory_kb << "\n";
+
+        QJsonObject latency;
+        latency["p50"] = Percentile(r.latencies_ms, 0.50);
+        latency["p90"] = Percentile(r.latencies_ms, 0.90);
+        latency["p99"] = Percentile(r.latencies_ms, 0.99);
+        latency["max"] = Percentile(r.latencies_ms, 1.0);
+
+        QJsonObject entry;
+        entry["filter"] = config.filter;
+        entry["method"] = MethodName(config.method);
+        entry["mode"] = ModeName(config.mode);
+        entry["records"] = static_cast<int>(records.size());
+        entry["samples"] = static_cast<double>(r.samples);
+        entry["tp"] = static_cast<double>(r.tp);
+        entry["fp"] = static_cast<double>(r.fp);
+        entry["fn"] = static_cast<double>(r.fn);
+        entry["sensitivity"] = sensitivity;
+        entry["ppv"] = ppv;
+        entry["timing_error_mean_ms"] = mean_error;
+        entry["timing_error_p95_ms"] = Percentile(r.timing_errors_ms, 0.95);
+        entry["samples_per_second"] = throughput;
+        entry["latency_ms"] = latency;
+        entry["peak_memory_kb"] = static_cast<double>(r.peak_memory_kb);
+        results_json.append(entry);
+    }
+
+    QJsonObject root;
+    root["generated_at"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    if (synthetic) {
+        root["synthetic"] = true;
+        root["frequency"] = records[0].dataset->frequency;
+        root["duration_seconds"] = static_cast<double>(records[0].dataset->Size()) /
+                                   records[0].dataset->frequency;
+    } else {
+        root["ludb_path"] = ludb_path;
+    }
+    root["tolerance_ms"] = MATCH_TOLERANCE_MS;
+    root["results"] = results_json;
+
+    QFile output(output_path);
+    if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "Error: Cannot write results to " << output_path.toStdString() << std::endl;
+        return 1;
+    }
+    output.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    output.close();
+
+    std::cerr << "Results written to " << output_path.toStdString() << std::endl;
+    return 0;
+}
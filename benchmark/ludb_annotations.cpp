@@ -0,0 +1,78 @@
+#include "ludb_annotations.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QByteArray>
+
+#include <cstdint>
+#include <iostream>
+
+namespace {
+    // Kody specjalne formatu MIT
+    constexpr int SKIP = 59;
+    constexpr int NUM = 60;
+    constexpr int SUB = 61;
+    constexpr int CHN = 62;
+    constexpr int AUX = 63;
+
+    // Kody adnotacji będących uderzeniami serca (ecgcodes.h: NORMAL..PACE, NAPC, PFUS, LEARN, BBB...)
+    bool IsBeat(int code) {
+        return (code >= 1 && code <= 13) || code == 25 || code == 30 || code == 34 || code == 35 || code == 38;
+    }
+}
+
+std::vector<long long> LoadQrsAnnotations(const QString &path) {
+    std::vector<long long> beats;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "Error: Cannot open annotation file: " << path.toStdString() << std::endl;
+        return beats;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    const auto *bytes = reinterpret_cast<const unsigned char *>(data.constData());
+    const qsizetype size = data.size();
+
+    long long time = 0;
+    qsizetype pos = 0;
+    while (pos + 1 < size) {
+        const int word = bytes[pos] | (bytes[pos + 1] << 8);
+        pos += 2;
+
+        const int code = word >> 10;
+        const int value = word & 0x3FF;
+
+        if (code == 0 && value == 0)
+            break;
+
+        switch (code) {
+            case SKIP: {
+                if (pos + 3 >= size) return beats;
+                // 32-bitowy interwał zapisany w kolejności PDP-11 (starsze słowo pierwsze)
+                const long interval = static_cast<int32_t>(
+                    (static_cast<uint32_t>(bytes[pos + 1]) << 24) |
+                    (static_cast<uint32_t>(bytes[pos]) << 16) |
+                    (static_cast<uint32_t>(bytes[pos + 3]) << 8) |
+                    static_cast<uint32_t>(bytes[pos + 2]));
+                time += interval;
+                pos += 4;
+                break;
+            }
+            case AUX:
+                pos += (value + 1) & ~1;
+                break;
+            case NUM:
+            case SUB:
+            case CHN:
+                break;
+            default:
+                time += value;
+                if (IsBeat(code))
+                    beats.push_back(time);
+                break;
+        }
+    }
+
+    return beats;
+}
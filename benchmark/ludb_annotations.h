@@ -0,0 +1,12 @@
+#ifndef EKG_LUDB_ANNOTATIONS_H
+#define EKG_LUDB_ANNOTATIONS_H
+#include <vector>
+
+#include <QString>
+
+// Wczytuje plik adnotacji WFDB (format MIT, np. ludb/1.ii) i zwraca numery próbek
+// adnotacji zespołów QRS (kody uderzeń serca, w LUDB głównie 'N').
+// Załamki P/T oraz znaczniki początku/końca fal są pomijane.
+std::vector<long long> LoadQrsAnnotations(const QString& path);
+
+#endif //EKG_LUDB_ANNOTATIONS_H
@@ -0,0 +1,69 @@
+#ifndef EKG_FFT_H
+#define EKG_FFT_H
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Szybka transformata Fouriera o mieszanej podstawie (2, 3, 4 oraz ogólny motylek dla
+// pozostałych czynników pierwszych). Plan - rozkład na czynniki i tablica współczynników
+// obrotu - jest liczony raz dla danego rozmiaru i współdzielony przez pamięć podręczną
+// ostatnio używanych rozmiarów, więc kolejne transformaty tej samej długości kosztują tylko
+// O(n log n) mnożeń.
+// Plany są niemodyfikowalne i mogą być używane równolegle z wielu wątków.
+class ComplexFFT {
+    size_t n_;
+    std::vector<size_t> factors_; // pary (podstawa, długość podproblemu)
+    std::vector<std::complex<double>> twiddles_;
+
+    void Work(std::complex<double>* out, const std::complex<double>* in, size_t fstride, const size_t* factors) const;
+
+    void Butterfly2(std::complex<double>* out, size_t fstride, size_t m) const;
+
+    void Butterfly3(std::complex<double>* out, size_t fstride, size_t m) const;
+
+    void Butterfly4(std::complex<double>* out, size_t fstride, size_t m) const;
+
+    void ButterflyGeneric(std::complex<double>* out, size_t fstride, size_t m, size_t p) const;
+
+public:
+    explicit ComplexFFT(size_t n);
+
+    size_t Size() const { return n_; }
+
+    // Transformata w przód (jądro exp(-2πikn/N)), bez normalizacji. in i out nie mogą się pokrywać.
+    void Forward(const std::complex<double>* in, std::complex<double>* out) const;
+
+    static std::shared_ptr<const ComplexFFT> ForSize(size_t n);
+};
+
+// Transformata sygnału rzeczywistego: n próbek -> n/2 + 1 współczynników zespolonych.
+// Dla parzystych n liczona przez transformatę zespoloną długości n/2.
+class RealFFT {
+    size_t n_;
+    std::shared_ptr<const ComplexFFT> half_;
+    std::shared_ptr<const ComplexFFT> full_;
+    std::vector<std::complex<double>> super_twiddles_;
+
+public:
+    explicit RealFFT(size_t n);
+
+    size_t Size() const { return n_; }
+
+    size_t SpectrumSize() const { return n_ / 2 + 1; }
+
+    // input - n próbek, output - n/2 + 1 współczynników.
+    // workspace jest buforem roboczym wywołującego (dowolnego rozmiaru, zostanie dopasowany),
+    // dzięki czemu wielokrotne transformaty nie alokują pamięci.
+    void Forward(const double* input, std::complex<double>* output,
+                 std::vector<std::complex<double>>& workspace) const;
+
+    void Forward(const double* input, std::complex<double>* output) const;
+
+    static std::shared_ptr<const RealFFT> ForSize(size_t n);
+
+    // Najmniejsza parzysta długość >= n postaci 2^a * 3^b * 5^c (do uzupełniania zerami)
+    static size_t NextFastSize(size_t n);
+};
+
+#endif //EKG_FFT_H
@@ -0,0 +1,39 @@
+#ifndef EKG_RR_RESAMPLER_H
+#define EKG_RR_RESAMPLER_H
+#include <cstddef>
+#include <vector>
+
+enum class ResamplingMode {
+    Linear,
+    CubicSpline // naturalny splajn kubiczny (zerowa druga pochodna na końcach)
+};
+
+// Przepróbkowanie nierównomiernej serii RR na siatkę równomierną (np. 4 Hz) przed analizą widmową.
+// Węzły interpolacji leżą w chwilach zakończenia kolejnych odstępów RR. Siatka wyjściowa i węzły
+// są przechodzone jednym kursorem (jak przy scalaniu), więc koszt to O(N + M). Bufory robocze
+// i wynikowy są składowymi obiektu i są używane ponownie przy kolejnych wywołaniach.
+class RRResampler {
+    double sampling_rate_;
+    ResamplingMode mode_;
+
+    std::vector<double> output_;
+    // Drugie pochodne splajnu w węzłach i bufor eliminacji układu trójprzekątniowego
+    std::vector<double> second_derivatives_;
+    std::vector<double> scratch_;
+
+    void PrepareSpline(const std::vector<double>& times, const std::vector<double>& values);
+
+public:
+    explicit RRResampler(double sampling_rate = 4.0, ResamplingMode mode = ResamplingMode::CubicSpline);
+
+    double SamplingRate() const { return sampling_rate_; }
+
+    ResamplingMode Mode() const { return mode_; }
+
+    // times - rosnące chwile węzłów [s], values - wartości w węzłach (np. odstępy RR w ms).
+    // Wynik zaczyna się w times.front() i ma próbki co 1 / sampling_rate aż do times.back().
+    // Zwrócona referencja jest ważna do następnego wywołania.
+    const std::vector<double>& Resample(const std::vector<double>& times, const std::vector<double>& values);
+};
+
+#endif //EKG_RR_RESAMPLER_H
@@ -0,0 +1,29 @@
+#ifndef EKG_SPECTRAL_WINDOW_H
+#define EKG_SPECTRAL_WINDOW_H
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+enum class WindowType {
+    Rectangular,
+    Hann,
+    Hamming,
+    Blackman
+};
+
+// Współczynniki okna czasowego wraz z sumą kwadratów (do normalizacji widma mocy).
+// Okna są liczone raz dla pary (rozmiar, typ) i współdzielone przez pamięć podręczną
+// ostatnio używanych par.
+class SpectralWindow {
+public:
+    std::vector<double> coefficients;
+    double power = 0.0; // suma kwadratów współczynników
+
+    SpectralWindow(size_t size, WindowType type);
+
+    size_t Size() const { return coefficients.size(); }
+
+    static std::shared_ptr<const SpectralWindow> ForSize(size_t size, WindowType type);
+};
+
+#endif //EKG_SPECTRAL_WINDOW_H
@@ -0,0 +1,32 @@
+#ifndef EKG_WELCH_ESTIMATOR_H
+#define EKG_WELCH_ESTIMATOR_H
+#include <cstddef>
+#include <vector>
+
+#include "spectral_window.h"
+
+// Estymator widma mocy metodą Welcha: uśrednione periodogramy nakładających się segmentów z oknem.
+// Okno i plan FFT pochodzą z pamięci podręcznych. Długie sygnały są dzielone na paczki segmentów
+// przetwarzane równolegle - każda paczka ma własne bufory i sumę częściową, a sumy są łączone
+// w ustalonej kolejności, więc wynik nie zależy od liczby wątków.
+class WelchEstimator {
+    size_t segment_size_;
+    double overlap_;
+    WindowType window_type_;
+
+public:
+    explicit WelchEstimator(size_t segment_size = 256, double overlap = 0.5, WindowType window_type = WindowType::Hann);
+
+    size_t SegmentSize() const { return segment_size_; }
+
+    // power - widmo mocy, frequencies - częstotliwości prążków [Hz]. Zwraca false (bez zmiany wyjść),
+    // gdy sygnał jest krótszy niż jeden segment.
+    bool Estimate(
+        const std::vector<double>& signal,
+        double sampling_rate,
+        std::vector<double>& power,
+        std::vector<double>& frequencies
+    ) const;
+};
+
+#endif //EKG_WELCH_ESTIMATOR_H
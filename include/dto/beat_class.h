@@ -0,0 +1,13 @@
+#ifndef EKG_BEAT_CLASS_H
+#define EKG_BEAT_CLASS_H
+#include <cstdint>
+
+// Klasa uderzenia (podział zbliżony do AAMI)
+enum class BeatClass : uint8_t {
+    Normal = 0,           // pobudzenie zatokowe (także z blokiem odnogi o dominującej morfologii)
+    Supraventricular = 1, // przedwczesne pobudzenie nadkomorowe
+    Ventricular = 2,      // pobudzenie komorowe
+    Unknown = 3           // brak danych do klasyfikacji (brzegi zapisu, brak sąsiednich odstępów RR)
+};
+
+#endif //EKG_BEAT_CLASS_H
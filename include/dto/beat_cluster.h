@@ -0,0 +1,19 @@
+#ifndef EKG_BEAT_CLUSTER_H
+#define EKG_BEAT_CLUSTER_H
+#include <cstddef>
+#include <vector>
+
+#include "beat_class.h"
+
+// Grupa uderzeń o podobnej morfologii QRS
+class BeatCluster {
+public:
+    // Wzorzec: znormalizowana (bez składowej stałej, norma 1) średnia morfologii członków
+    std::vector<float> morphology;
+    // Indeksy uderzeń należących do grupy, rosnąco
+    std::vector<size_t> members;
+    // Klasa przeważająca wśród członków
+    BeatClass label = BeatClass::Unknown;
+};
+
+#endif //EKG_BEAT_CLUSTER_H
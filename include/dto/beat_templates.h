@@ -0,0 +1,49 @@
+#ifndef EKG_BEAT_TEMPLATES_H
+#define EKG_BEAT_TEMPLATES_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../model/signal_datapoint.h"
+#include "../model/signal_dataset.h"
+
+// Uśrednione i medianowe uderzenie każdego kanału sygnału, wyrównane do piku R.
+// Próbka r_offset odpowiada pikowi R; wartości są ułożone kanałami: [lead * length + k].
+// Argument lead w Mean, Median i kanały MedianBeat to indeksy przechowywanych kanałów, a nie odprowadzeń
+// standardowych - w trybie derived_limb_leads kanał 2 to V1. Odprowadzenie zamienia na kanał StorageIndex.
+class BeatTemplates {
+public:
+    int frequency = 0;
+    int64_t r_offset = 0;  // liczba próbek przed pikiem R
+    size_t length = 0;     // długość wzorca [próbki]
+    size_t lead_count = 0; // liczba kanałów
+    size_t beat_count = 0; // liczba uderzeń, z których policzono wzorce
+
+    // Układ kanałów jak w SignalDataset: true - tylko I, II, V1..V6
+    bool derived_limb_leads = false;
+
+    std::vector<float> mean;
+    std::vector<float> median;
+
+    float Mean(size_t lead, size_t k) const { return mean[lead * length + k]; }
+
+    float Median(size_t lead, size_t k) const { return median[lead * length + k]; }
+
+    bool Empty() const { return beat_count == 0; }
+
+    // Kanał wzorca dla odprowadzenia SignalDataset::Lead albo -1, jeśli odprowadzenie nie jest przechowywane
+    int StorageIndex(size_t lead) const { return SignalDataset::StorageIndex(lead, derived_limb_leads); }
+
+    // Wzorzec medianowy jako krótki sygnał wielokanałowy - można go podać do detekcji załamków
+    // lub klasyfikacji tak jak zwykły zapis, z jednym pikiem R w próbce r_offset
+    std::vector<SignalDatapoint> MedianBeat() const {
+        std::vector<SignalDatapoint> beat(length);
+        for (size_t k = 0; k < length; ++k) {
+            beat[k].channelValues.resize(lead_count);
+            for (size_t lead = 0; lead < lead_count; ++lead) beat[k].channelValues[lead] = Median(lead, k);
+        }
+        return beat;
+    }
+};
+
+#endif //EKG_BEAT_TEMPLATES_H
@@ -1,8 +1,38 @@
 #ifndef EKG_HEART_CLASS_RESULT_H
 #define EKG_HEART_CLASS_RESULT_H
+#include <cstddef>
+#include <vector>
 
+#include "beat_class.h"
+#include "beat_cluster.h"
+
+// Wynik klasyfikacji uderzeń. labels[i] odpowiada i-temu uderzeniu z wejścia (kolejność pików R).
 class HeartClassResult {
-    // TODO(Jeremiasz): trzeba uzupełnić
+public:
+    static constexpr size_t CLASS_COUNT = 4;
+
+    std::vector<BeatClass> labels;
+
+    // Grupy morfologiczne uderzeń, od najliczniejszej (clusters[0] to morfologia dominująca)
+    std::vector<BeatCluster> clusters;
+
+    // Liczba uderzeń w każdej klasie, indeksowana wartością BeatClass
+    size_t counts[CLASS_COUNT] = {0, 0, 0, 0};
+
+    // Podsumowanie rytmu
+    size_t ventricular_couplets = 0;      // dokładnie dwa kolejne pobudzenia komorowe
+    size_t ventricular_runs = 0;          // co najmniej trzy kolejne pobudzenia komorowe (salwy)
+    size_t supraventricular_runs = 0;     // co najmniej trzy kolejne pobudzenia nadkomorowe
+    size_t ventricular_bigeminy = 0;      // epizody co najmniej trzech cykli N-V
+    size_t supraventricular_bigeminy = 0; // epizody co najmniej trzech cykli N-S
+
+    size_t Count(BeatClass beat_class) const { return counts[static_cast<size_t>(beat_class)]; }
+
+    // Odsetek pobudzeń danej klasy wśród uderzeń sklasyfikowanych (bez Unknown), 0..1
+    double Burden(BeatClass beat_class) const {
+        const size_t classified = labels.size() - Count(BeatClass::Unknown);
+        return classified > 0 ? static_cast<double>(Count(beat_class)) / static_cast<double>(classified) : 0.0;
+    }
 };
 
 #endif //EKG_HEART_CLASS_RESULT_H
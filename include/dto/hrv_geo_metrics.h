@@ -7,6 +7,8 @@ public:
     double triangular_index = 0.0;
     double tinn = 0.0;
     std::vector<double> histogram;
+    double histogram_start = 0.0;     // lewa krawędź pierwszego przedziału histogramu [ms]
+    double histogram_bin_width = 0.0; // szerokość przedziału [ms]
     double sd1 = 0.0;
     double sd2 = 0.0;
 };
@@ -0,0 +1,16 @@
+#ifndef EKG_HRV_NONLINEAR_METRICS_H
+#define EKG_HRV_NONLINEAR_METRICS_H
+#include <vector>
+
+// Nieliniowe metryki HRV oparte na entropii serii odstępów NN
+class HRVNonlinearMetrics {
+public:
+    double sample_entropy = 0.0;      // SampEn(m, r)
+    double approximate_entropy = 0.0; // ApEn(m, r)
+
+    // Entropia wieloskalowa: SampEn serii uśrednionej w oknach 1, 2, ..., N uderzeń
+    // (element i odpowiada skali i + 1; brak dopasowań daje wartość ujemną -1)
+    std::vector<double> multiscale_entropy;
+};
+
+#endif //EKG_HRV_NONLINEAR_METRICS_H
@@ -0,0 +1,30 @@
+#ifndef EKG_HRV_SPECTROGRAM_H
+#define EKG_HRV_SPECTROGRAM_H
+#include <cstddef>
+#include <vector>
+
+// Spektrogram HRV (STFT przepróbkowanej serii RR) wraz z przebiegami mocy w pasmach VLF/LF/HF.
+// Przechowywane są tylko prążki do SpectralOptions::spectrogram_max_frequency (domyślnie górna granica
+// pasma HF), w pojedynczej precyzji.
+class HRVSpectrogram {
+public:
+    double window_seconds = 0.0;
+    double step_seconds = 0.0;
+    double frequency_step = 0.0; // odstęp prążków [Hz], prążek b ma częstotliwość b * frequency_step
+
+    size_t frames = 0;
+    size_t bins = 0;
+
+    // Jednostronna gęstość widmowa mocy [ms^2 / Hz] - [frame * bins + bin]
+    std::vector<float> power;
+
+    // Dla każdej ramki: środek okna [s, w osi czasu sygnału] i moc w pasmach [ms^2] (suma gęstości razy frequency_step)
+    std::vector<float> frame_times;
+    std::vector<float> vlf;
+    std::vector<float> lf;
+    std::vector<float> hf;
+
+    float At(size_t frame, size_t bin) const { return power[frame * bins + bin]; }
+};
+
+#endif //EKG_HRV_SPECTROGRAM_H
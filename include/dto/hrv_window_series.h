@@ -0,0 +1,22 @@
+#ifndef EKG_HRV_WINDOW_SERIES_H
+#define EKG_HRV_WINDOW_SERIES_H
+#include <cstddef>
+#include <vector>
+
+#include "hrv_time_metrics.h"
+
+// Przebieg krótkoterminowych metryk HRV w oknach przesuwnych (np. 5 min co 5 min przez całą dobę)
+class HRVWindowSeries {
+public:
+    double window_seconds = 0.0;
+    double step_seconds = 0.0;
+
+    // Dla każdego okna: początek [s, w osi czasu sygnału], liczba odstępów NN i metryki
+    std::vector<double> start_times;
+    std::vector<int> nn_counts;
+    std::vector<HRVTimeMetrics> windows;
+
+    size_t Size() const { return windows.size(); }
+};
+
+#endif //EKG_HRV_WINDOW_SERIES_H
@@ -0,0 +1,44 @@
+#ifndef EKG_SIGNAL_QUALITY_H
+#define EKG_SIGNAL_QUALITY_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Wskaźnik jakości sygnału (SQI) liczony w segmentach o stałej długości, osobno dla każdego odprowadzenia
+class SignalQuality {
+public:
+    // Przyczyny obniżenia jakości (maska bitowa)
+    enum Flag : uint8_t {
+        None = 0,
+        Flatline = 1,        // elektroda odłączona - brak zmienności sygnału
+        Saturation = 2,      // nasycenie przetwornika - plateau na skrajnych wartościach
+        LowKurtosis = 4,     // rozkład bliski szumowi - brak wyraźnych zespołów QRS
+        Noise = 8,           // przewaga energii wysokich częstotliwości
+        NoBeatAgreement = 16 // odprowadzenie nie potwierdza uderzeń wykrytych przez detektor
+    };
+
+    int segment_length = 0; // długość segmentu w próbkach
+    int leads = 0;
+
+    // Ocena 0..1 i flagi dla [segment * leads + lead]
+    std::vector<float> scores;
+    std::vector<uint8_t> flags;
+
+    // Czy segment nadaje się do dalszej analizy
+    std::vector<bool> usable;
+
+    size_t SegmentCount() const { return usable.size(); }
+
+    float Score(size_t segment, int lead) const { return scores[segment * leads + lead]; }
+
+    uint8_t Flags(size_t segment, int lead) const { return flags[segment * leads + lead]; }
+
+    // Czy próbka o podanym indeksie leży w segmencie nadającym się do analizy
+    bool IsUsable(int64_t sample) const {
+        if (segment_length <= 0 || sample < 0) return true;
+        const size_t segment = static_cast<size_t>(sample / segment_length);
+        return segment >= usable.size() || usable[segment];
+    }
+};
+
+#endif //EKG_SIGNAL_QUALITY_H
@@ -1,10 +1,35 @@
 #ifndef EKG_SIGNAL_RANGE_H
 #define EKG_SIGNAL_RANGE_H
+#include <algorithm>
+#include <cstdint>
 
+#include "../util/sample_time.h"
+
+// Zakres próbek [start, end) jako indeksy int64_t liczone od początku zapisu
 class SignalRange {
 public:
-    float start;
-    float end;
+    int64_t start = 0;
+    int64_t end = 0;
+
+    int64_t Length() const { return std::max<int64_t>(0, end - start); }
+
+    bool Contains(int64_t sample) const { return sample >= start && sample < end; }
+
+    double StartSeconds(int frequency) const { return SampleToSeconds(start, frequency); }
+
+    double EndSeconds(int frequency) const { return SampleToSeconds(end, frequency); }
+
+    // Zakres dla przedziału czasu w sekundach od początku zapisu
+    static SignalRange FromSeconds(double start_seconds, double end_seconds, int frequency) {
+        return {SecondsToSample(start_seconds, frequency), SecondsToSample(end_seconds, frequency)};
+    }
+
+    // Zakres dla przedziału znaczników bezwzględnych [us] zapisu rozpoczętego w chwili start_us
+    static SignalRange FromTimestamps(int64_t start_timestamp_us, int64_t end_timestamp_us, int frequency,
+                                      int64_t start_us) {
+        return {TimestampToSample(start_timestamp_us, frequency, start_us),
+                TimestampToSample(end_timestamp_us, frequency, start_us)};
+    }
 };
 
 #endif //EKG_SIGNAL_RANGE_H
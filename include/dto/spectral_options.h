@@ -0,0 +1,35 @@
+#ifndef EKG_SPECTRAL_OPTIONS_H
+#define EKG_SPECTRAL_OPTIONS_H
+#include "../dsp/rr_resampler.h"
+#include "../dsp/spectral_window.h"
+
+// Parametry estymacji widma HRV
+class SpectralOptions {
+public:
+    // Przepróbkowanie serii RR przed periodogramem klasycznym i Welcha
+    double resampling_rate = 4.0; // 4 Hz - standardowa częstotliwość dla HRV
+    ResamplingMode resampling_mode = ResamplingMode::CubicSpline;
+
+    // Periodogram Welcha: długość segmentu [s] (64 s przy 4 Hz to 256 próbek), nakładanie segmentów 0..1, okno
+    double welch_segment_seconds = 64.0;
+    double welch_overlap = 0.5;
+    WindowType welch_window = WindowType::Hann;
+
+    // Siatka częstotliwości periodogramu Lomb-Scargle [Hz]. Krok siatki to 1 / (oversampling * T),
+    // gdzie T to czas trwania serii RR, więc oversampling > 1 zagęszcza siatkę ponad rozdzielczość naturalną.
+    double min_frequency = 0.0033;
+    double max_frequency = 0.4;
+    double oversampling = 4.0;
+
+    // Górna granica prążków zapisywanych w spektrogramie (STFT) [Hz], niezależna od siatki Lomb-Scargle
+    double spectrogram_max_frequency = 0.4;
+
+    // Rząd interpolacji Lagrange'a przy rozrzucaniu próbek na siatkę FFT (szybki Lomb-Scargle)
+    int extirpolation_order = 4;
+
+    // Liczba par (próbka, częstotliwość), poniżej której Lomb-Scargle liczony jest wprost - dla krótkich
+    // serii bezpośrednia suma jest szybsza od FFT i dokładna
+    long long direct_lomb_scargle_limit = 1 << 16;
+};
+
+#endif //EKG_SPECTRAL_OPTIONS_H
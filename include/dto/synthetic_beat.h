@@ -0,0 +1,14 @@
+#ifndef EKG_SYNTHETIC_BEAT_H
+#define EKG_SYNTHETIC_BEAT_H
+#include <cstdint>
+
+#include "beat_class.h"
+
+// Adnotacja uderzenia zapisu syntetycznego: dokładne położenie szczytu R i klasa pobudzenia
+class SyntheticBeat {
+public:
+    int64_t r_peak = 0;
+    BeatClass beat_class = BeatClass::Normal;
+};
+
+#endif //EKG_SYNTHETIC_BEAT_H
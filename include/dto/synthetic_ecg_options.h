@@ -0,0 +1,44 @@
+#ifndef EKG_SYNTHETIC_ECG_OPTIONS_H
+#define EKG_SYNTHETIC_ECG_OPTIONS_H
+#include <cstdint>
+#include <limits>
+
+// Parametry syntetycznego zapisu EKG (SyntheticSignalRepository)
+class SyntheticECGOptions {
+public:
+    // Ziarno generatora - te same parametry i ziarno dają identyczny zapis, niezależnie od liczby wątków
+    uint64_t seed = 1;
+
+    int frequency = 500;            // [Hz]
+    double duration_seconds = 60.0;
+
+    // Początek zapisu [us od 1970-01-01 UTC], domyślnie nieznany (jak SignalDataset::NO_START_TIME)
+    int64_t start_time_us = std::numeric_limits<int64_t>::min();
+
+    // Zbiór danych tylko z odprowadzeniami niezależnymi (I, II, V1..V6) - jak w DATSignalRepository
+    bool independent_leads_only = false;
+
+    // Rytm zatokowy: średnia częstość [bpm] i zmienność RR (SDNN [ms]) złożona z dwóch pasm -
+    // LF (fale Mayera) i HF (arytmia oddechowa) w proporcji mocy lf_hf_ratio
+    double heart_rate = 70.0;
+    double hrv_std_ms = 40.0;
+    double lf_hf_ratio = 0.5;
+    double lf_frequency = 0.1;  // [Hz]
+    double hf_frequency = 0.25; // [Hz]
+
+    // Prawdopodobieństwo, że kolejne uderzenie jest przedwczesnym pobudzeniem komorowym / nadkomorowym
+    double ventricular_ectopy = 0.0;
+    double supraventricular_ectopy = 0.0;
+
+    // Zakłócenia [mV]: szum biały, pływanie linii izoelektrycznej (oddech i składowa wolna) i sieć
+    double noise_std = 0.01;
+    double baseline_wander = 0.1;
+    double respiration_frequency = 0.25; // [Hz]
+    double powerline_amplitude = 0.0;
+    double powerline_frequency = 50.0;   // [Hz]
+
+    // Wzmocnienie przetwornika przy zapisie .dat i w zapisie Int16 [jednostki / mV]
+    double adc_gain = 1000.0;
+};
+
+#endif //EKG_SYNTHETIC_ECG_OPTIONS_H
@@ -0,0 +1,23 @@
+#ifndef EKG_VECTORCARDIOGRAM_H
+#define EKG_VECTORCARDIOGRAM_H
+#include <cstddef>
+#include <vector>
+
+// Odprowadzenia ortogonalne X, Y, Z (wektokardiogram) i długość wektora przestrzennego w każdej próbce.
+// Jednostki jak w sygnale źródłowym.
+class Vectorcardiogram {
+public:
+    int frequency = 0;
+
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    // |(X, Y, Z)| - sygnał niezależny od wyboru odprowadzenia, np. do detekcji zespołów QRS
+    std::vector<float> magnitude;
+
+    size_t Size() const { return magnitude.size(); }
+
+    bool Empty() const { return magnitude.empty(); }
+};
+
+#endif //EKG_VECTORCARDIOGRAM_H
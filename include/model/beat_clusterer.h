@@ -0,0 +1,51 @@
+#ifndef EKG_BEAT_CLUSTERER_H
+#define EKG_BEAT_CLUSTERER_H
+#include <cstddef>
+#include <vector>
+
+#include "../dto/beat_cluster.h"
+
+// Przyrostowe grupowanie uderzeń według morfologii. Każde uderzenie (wektor o stałej długości, bez składowej
+// stałej i o normie 1) jest porównywane z bieżącymi wzorcami grup; odległość euklidesowa między wektorami
+// jednostkowymi wynosi 2 - 2·korelacja, więc próg korelacji przekłada się na próg odległości. Sumowanie
+// odległości jest przerywane, gdy suma częściowa przekroczy najlepszy dotychczasowy wynik - większość
+// porównań z niepasującymi grupami kończy się po kilku blokach próbek.
+// Wzorce są przechowywane jeden za drugim w jednej tablicy, a wymiar jest uzupełniany zerami do
+// wielokrotności BLOCK, żeby pętle po blokach wektoryzowały się bez obsługi reszty.
+class BeatClusterer {
+public:
+    static constexpr size_t BLOCK = 8;
+
+private:
+    size_t dimension_;
+    size_t stride_;
+    float max_distance_;
+    size_t max_clusters_;
+
+    std::vector<float> templates_; // clusters × stride_, wzorce znormalizowane
+    std::vector<double> sums_;     // clusters × stride_, sumy morfologii członków
+    std::vector<std::vector<size_t>> members_;
+    std::vector<float> input_;     // bieżące uderzenie uzupełnione zerami do stride_
+    size_t last_cluster_ = 0;
+    size_t count_ = 0;
+
+    // Kwadrat odległości od wzorca lub wartość > bound, jeśli przekroczy bound
+    float Distance(const float* morphology, const float* pattern, float bound) const;
+
+    void Assign(size_t cluster, const float* morphology);
+
+public:
+    // dimension - długość wektora morfologii, min_correlation - próg przyjęcia do grupy,
+    // max_clusters - po osiągnięciu limitu uderzenie trafia do najbliższej grupy
+    explicit BeatClusterer(size_t dimension, double min_correlation = 0.9, size_t max_clusters = 64);
+
+    // Dodaje kolejne uderzenie i zwraca indeks grupy, do której trafiło
+    size_t Add(const float* morphology);
+
+    size_t ClusterCount() const { return members_.size(); }
+
+    // Grupy posortowane malejąco według liczności
+    std::vector<BeatCluster> Clusters() const;
+};
+
+#endif //EKG_BEAT_CLUSTERER_H
@@ -0,0 +1,28 @@
+#ifndef EKG_BEAT_FIDUCIALS_H
+#define EKG_BEAT_FIDUCIALS_H
+#include <cstdint>
+
+// Punkty charakterystyczne jednego uderzenia jako indeksy próbek sygnału.
+// Fala, której nie udało się wyznaczyć (np. brak załamka P przy migotaniu przedsionków), ma wartości NONE.
+class BeatFiducials {
+public:
+    static constexpr int64_t NONE = -1;
+
+    int64_t p_onset = NONE;
+    int64_t p_peak = NONE;
+    int64_t p_offset = NONE;
+
+    int64_t qrs_onset = NONE;
+    int64_t r_peak = NONE;
+    int64_t qrs_offset = NONE;
+
+    int64_t t_onset = NONE;
+    int64_t t_peak = NONE;
+    int64_t t_offset = NONE;
+
+    bool HasPWave() const { return p_peak != NONE; }
+
+    bool HasTWave() const { return t_peak != NONE; }
+};
+
+#endif //EKG_BEAT_FIDUCIALS_H
@@ -0,0 +1,71 @@
+#ifndef EKG_COMPACT_SIGNAL_H
+#define EKG_COMPACT_SIGNAL_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "signal_datapoint.h"
+
+// Sposób przechowywania próbek zbioru danych
+enum class SampleStorage : uint8_t {
+    Float32, // SignalDatapoint::channelValues (domyślnie)
+    Int16,   // surowe wartości przetwornika + wzmocnienie i linia zerowa kanału (bez strat dla plików .dat)
+    Float16  // IEEE half - ok. 3 cyfry znaczące, wystarcza dla sygnału w mV
+};
+
+// Sygnał wielokanałowy w 16 bitach na próbkę. Każdy kanał leży w osobnym ciągłym buforze, więc odczyt
+// zakresu jednego kanału (ReadLead) to prosta pętla konwersji uint16/int16 -> float, którą kompilator
+// wektoryzuje. Dla Int16 wartość fizyczna to (surowa - baseline) / gain.
+class CompactSignal {
+    SampleStorage storage_;
+    size_t size_;
+    size_t lead_count_;
+    std::vector<uint16_t> samples_; // [lead * size_ + sample]
+    std::vector<float> scale_;      // 1 / gain
+    std::vector<float> offset_;     // -baseline / gain
+    std::vector<double> gain_;
+    std::vector<double> baseline_;
+
+public:
+    // storage - Int16 lub Float16; wzmocnienia kanałów Int16 domyślnie 1, linie zerowe 0
+    CompactSignal(SampleStorage storage, size_t size, size_t lead_count);
+
+    // Kompresja istniejącego sygnału. Dla Int16 wzmocnienie kanału dobierane jest tak, żeby największa
+    // amplituda zajęła prawie cały zakres int16.
+    static CompactSignal FromDatapoints(const std::vector<SignalDatapoint>& datapoints, SampleStorage storage);
+
+    SampleStorage Storage() const { return storage_; }
+
+    size_t Size() const { return size_; }
+
+    size_t LeadCount() const { return lead_count_; }
+
+    size_t MemoryBytes() const { return samples_.size() * sizeof(uint16_t); }
+
+    // Tylko Int16: skala kanału
+    void SetLeadScale(size_t lead, double gain, double baseline);
+
+    double Gain(size_t lead) const { return gain_[lead]; }
+
+    double Baseline(size_t lead) const { return baseline_[lead]; }
+
+    // Tylko Int16: surowa wartość przetwornika
+    void SetRaw(size_t sample, size_t lead, int16_t raw) {
+        samples_[lead * size_ + sample] = static_cast<uint16_t>(raw);
+    }
+
+    int16_t Raw(size_t sample, size_t lead) const { return static_cast<int16_t>(samples_[lead * size_ + sample]); }
+
+    // Zapis wartości fizycznej (Int16 - kwantyzacja ze skalą kanału z nasyceniem)
+    void Set(size_t sample, size_t lead, float value);
+
+    float At(size_t sample, size_t lead) const;
+
+    // Odczyt count próbek kanału od from do ciągłego bufora out
+    void ReadLead(size_t lead, size_t from, size_t count, float* out) const;
+
+    // Zakres próbek w postaci wielokanałowych SignalDatapoint (jak w pamięci Float32)
+    std::vector<SignalDatapoint> ToDatapoints(size_t from, size_t count) const;
+};
+
+#endif //EKG_COMPACT_SIGNAL_H
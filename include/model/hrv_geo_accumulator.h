@@ -0,0 +1,51 @@
+#ifndef EKG_HRV_GEO_ACCUMULATOR_H
+#define EKG_HRV_GEO_ACCUMULATOR_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "../dto/hrv_geo_metrics.h"
+
+// Jednoprzebiegowy akumulator geometrycznych metryk HRV o stałym rozmiarze pamięci.
+// Momenty wykresu Poincaré liczone są metodą Welforda, histogram ma stały początek (0 ms) i przedziały
+// 1/128 s, więc akumulatory z różnych fragmentów serii (lub z różnych wątków) można łączyć przez Merge
+// i dostać ten sam wynik co dla całej serii. Nadaje się też do aktualizacji na bieżąco, uderzenie po uderzeniu.
+class HRVGeoAccumulator {
+public:
+    static constexpr double BIN_WIDTH_MS = 1000.0 / 128.0;
+    static constexpr size_t BIN_COUNT = 256; // 0..2000 ms, dłuższe odstępy trafiają do ostatniego przedziału
+
+private:
+    std::vector<uint32_t> histogram_;
+    size_t interval_count_ = 0;
+
+    // Momenty punktów Poincaré: x = (RR_n + RR_n-1) / sqrt(2), y = (RR_n - RR_n-1) / sqrt(2)
+    size_t pair_count_ = 0;
+    double mean_x_ = 0.0, mean_y_ = 0.0;
+    double m2_x_ = 0.0, m2_y_ = 0.0;
+
+    // Ostatni odstęp dla Add() - pozwala podawać serię po jednym odstępie
+    double last_interval_ = 0.0;
+    bool has_last_ = false;
+
+public:
+    HRVGeoAccumulator();
+
+    // Dodaje odstęp do histogramu
+    void AddInterval(double interval_ms);
+
+    // Dodaje punkt wykresu Poincaré dla pary kolejnych odstępów
+    void AddPair(double previous_ms, double current_ms);
+
+    // Dodaje odstęp; successive - czy bezpośrednio następuje po poprzednio dodanym (tworzy z nim parę)
+    void Add(double interval_ms, bool successive = true);
+
+    // Dołącza stan innego akumulatora (wzory Chana dla momentów, suma histogramów)
+    void Merge(const HRVGeoAccumulator& other);
+
+    size_t IntervalCount() const { return interval_count_; }
+
+    HRVGeoMetrics Metrics() const;
+};
+
+#endif //EKG_HRV_GEO_ACCUMULATOR_H
@@ -0,0 +1,52 @@
+#ifndef EKG_RR_SERIES_H
+#define EKG_RR_SERIES_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "r_peaks_annotated_signal_datapoint.h"
+#include "../dto/signal_quality.h"
+
+// Seria odstępów RR wyznaczana raz z wyniku detektora pików R i współdzielona przez wszystkie moduły HRV.
+// Odstęp i kończy się na piku peaks[i + 1]; odstępy oznaczone flagą nie są odstępami NN (normal-to-normal)
+// i nie wchodzą do metryk, ale zostają w serii, żeby zachować ciągłość osi czasu.
+class RRSeries {
+public:
+    // Przyczyny odrzucenia odstępu (maska bitowa)
+    enum Flag : uint8_t {
+        None = 0,
+        OutOfRange = 1,   // odstęp poza zakresem fizjologicznym (artefakt lub pominięte uderzenie)
+        LowQuality = 2    // co najmniej jeden z pików leży w segmencie o złej jakości sygnału
+    };
+
+    int frequency = 0;
+
+    std::vector<int64_t> peaks;     // indeksy próbek kolejnych pików R
+    std::vector<double> times;      // chwila zakończenia odstępu [s]
+    std::vector<double> intervals;  // długość odstępu [ms]
+    std::vector<uint8_t> flags;
+
+    // Widok samych odstępów NN (kopie z zachowaniem kolejności)
+    std::vector<double> nn_times;
+    std::vector<double> nn_intervals;
+    // Czy odstęp NN o danym indeksie bezpośrednio następuje po poprzednim odstępie NN w pełnej serii
+    // (różnice kolejnych odstępów, np. RMSSD i Poincaré, nie mogą przeskakiwać przez artefakty)
+    std::vector<bool> nn_successive;
+
+    size_t Size() const { return intervals.size(); }
+
+    size_t NNCount() const { return nn_intervals.size(); }
+
+    bool IsNN(size_t i) const { return flags[i] == None; }
+
+    // Buduje serię z oznaczonych pików. quality (opcjonalnie) oznacza odstępy w segmentach nieprzydatnych.
+    static RRSeries FromPeaks(
+        const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks,
+        int frequency,
+        const SignalQuality* quality = nullptr,
+        double min_interval_ms = 300.0,
+        double max_interval_ms = 2000.0
+    );
+};
+
+#endif //EKG_RR_SERIES_H
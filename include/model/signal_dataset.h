@@ -1,13 +1,103 @@
 #ifndef EKG_SIGNAL_DATASET_H
 #define EKG_SIGNAL_DATASET_H
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <vector>
 
+#include "compact_signal.h"
 #include "signal_datapoint.h"
+#include "../util/sample_time.h"
 
 class SignalDataset {
 public:
+    // Kolejność odprowadzeń standardowego zapisu 12-odprowadzeniowego
+    enum Lead : size_t { I = 0, II, III, AVR, AVL, AVF, V1, V2, V3, V4, V5, V6, STANDARD_LEAD_COUNT };
+
+    // Odprowadzenia niezależne: I, II, V1..V6. III, aVR, aVL i aVF są ich kombinacjami liniowymi.
+    static constexpr size_t INDEPENDENT_LEAD_COUNT = 8;
+
     std::vector<SignalDatapoint> values;
     int frequency;
+
+    // Początek zapisu w mikrosekundach od 1970-01-01 UTC albo NO_START_TIME, jeśli nagłówek go nie podaje
+    static constexpr int64_t NO_START_TIME = std::numeric_limits<int64_t>::min();
+    int64_t start_time_us = NO_START_TIME;
+
+    // true - channelValues zawiera tylko odprowadzenia niezależne w kolejności I, II, V1..V6,
+    // a III, aVR, aVL i aVF są wyliczane przy pierwszym dostępie (DerivedLead, Value, Expanded)
+    bool derived_limb_leads = false;
+
+    // Odprowadzenia wyliczane w jednostkach fizycznych: wartość = w_I · I + w_II · II + przesunięcie,
+    // kolejno dla III, aVR, aVL i aVF. Zależności Einthovena i Goldbergera są dokładne w jednostkach
+    // przetwornika, więc przy różnych wzmocnieniach kanałów repozytorium przelicza wagi z nagłówka.
+    static constexpr float DERIVED_LEAD_COMBINATION[4][2] = {{-1.0f, 1.0f}, {-0.5f, -0.5f}, {1.0f, -0.5f}, {-0.5f, 1.0f}};
+    float derived_lead_weights[4][3] = {{-1.0f, 1.0f, 0.0f}, {-0.5f, -0.5f, 0.0f}, {1.0f, -0.5f, 0.0f}, {-0.5f, 1.0f, 0.0f}};
+
+    // Przy zapisie 16-bitowym (SampleStorage::Int16 / Float16) próbki leżą tutaj, a values jest puste.
+    // Odczyt niezależny od sposobu przechowywania: Size, ChannelCount, ReadChannel, Samples.
+    std::shared_ptr<const CompactSignal> compact;
+
+    SignalDataset() = default;
+
+    SignalDataset(const SignalDataset& other);
+
+    SignalDataset& operator=(const SignalDataset& other);
+
+    size_t Size() const { return compact ? compact->Size() : values.size(); }
+
+    bool HasStartTime() const { return start_time_us != NO_START_TIME; }
+
+    // Czas próbki w sekundach od początku zapisu i najbliższa próbka dla chwili w sekundach
+    double Seconds(int64_t sample) const { return SampleToSeconds(sample, frequency); }
+
+    int64_t SampleAt(double seconds) const { return SecondsToSample(seconds, frequency); }
+
+    // Znacznik bezwzględny próbki [us] i próbka dla znacznika (tylko gdy HasStartTime())
+    int64_t Timestamp(int64_t sample) const { return SampleToTimestamp(sample, frequency, start_time_us); }
+
+    int64_t SampleAtTimestamp(int64_t timestamp_us) const {
+        return TimestampToSample(timestamp_us, frequency, start_time_us);
+    }
+
+    // Liczba przechowywanych kanałów (8 w trybie derived_limb_leads)
+    size_t ChannelCount() const;
+
+    // count próbek przechowywanego kanału od from do ciągłego bufora out
+    void ReadChannel(size_t channel, size_t from, size_t count, float* out) const;
+
+    // Zakres próbek jako SignalDatapoint w układzie przechowywanych kanałów (przy zapisie 16-bitowym - rozwinięty do float)
+    std::vector<SignalDatapoint> Samples(size_t from, size_t count) const;
+
+    // Liczba odprowadzeń widocznych dla użytkownika (12 w trybie derived_limb_leads)
+    size_t LeadCount() const;
+
+    // Indeks odprowadzenia w channelValues albo -1, jeśli odprowadzenie jest wyliczane
+    int StorageIndex(size_t lead) const { return StorageIndex(lead, derived_limb_leads); }
+
+    // To samo dla dowolnego sygnału o układzie kanałów zbioru danych (np. po filtracji)
+    static int StorageIndex(size_t lead, bool derived_limb_leads);
+
+    // Wartość dowolnego odprowadzenia w próbce (wyliczane - z I i II tej samej próbki, bez bufora i blokady)
+    float Value(size_t sample, size_t lead) const;
+
+    // Ciągły bufor odprowadzenia III, aVR, aVL lub aVF. Wszystkie cztery są liczone razem jednym przebiegiem
+    // przy pierwszym dostępie i zapamiętywane; kolejne wywołania (także z innych wątków) tylko je zwracają.
+    // Zwracany wskaźnik współdzieli bufor, więc pozostaje ważny także po InvalidateDerivedLeads lub
+    // przypisaniu zbioru w innym wątku. Po zmianie values należy wywołać InvalidateDerivedLeads.
+    // nullptr dla odprowadzeń przechowywanych albo gdy zbiór nie jest w trybie derived_limb_leads.
+    std::shared_ptr<const std::vector<float>> DerivedLead(size_t lead) const;
+
+    void InvalidateDerivedLeads();
+
+    // Pełny zapis 12-odprowadzeniowy dla modułów, które potrzebują wszystkich odprowadzeń w channelValues
+    std::vector<SignalDatapoint> Expanded() const;
+
+private:
+    mutable std::mutex derived_mutex_;
+    mutable std::shared_ptr<const std::vector<float>> derived_[4]; // III, aVR, aVL, aVF
 };
 
 #endif //EKG_SIGNAL_DATASET_H
@@ -0,0 +1,39 @@
+#ifndef EKG_COMPRESSED_SIGNAL_REPOSITORY_H
+#define EKG_COMPRESSED_SIGNAL_REPOSITORY_H
+
+#include <cstdint>
+
+#include "abstract/signal_repository.h"
+#include <QString>
+
+// Bezstratny format archiwalny zapisów EKG (.ekgz).
+//
+// Próbki przechowywane są jako surowe wartości przetwornika (int16) ze wzmocnieniem i linią zerową kanału.
+// Sygnał jest dzielony na bloki po block_size próbek, a każdy blok każdego kanału kodowany jest niezależnie:
+// stały predyktor rzędu 0-3 (różnice kolejnych rzędów, wybierany dla bloku) i kod Rice'a reszt z parametrem
+// dobranym do bloku. Tablica przesunięć bloków w nagłówku pozwala odczytać dowolny zakres czasu bez czytania
+// całego pliku, a bloki są dekodowane równolegle.
+//
+// Układ pliku (little endian):
+//   "EKGZ", u16 wersja, u16 liczba kanałów, i32 częstotliwość, u64 liczba próbek, u32 block_size,
+//   u8 flagi (bit 0 - derived_limb_leads), 3 bajty zarezerwowane, i64 początek zapisu [us], kanały × (f64 wzmocnienie, f64 linia zerowa),
+//   [derived_limb_leads: 4 × 3 × f32 wagi odprowadzeń wyliczanych], u64 liczba bloków,
+//   (liczba bloków + 1) × u64 przesunięcie bloku względem początku danych, dane bloków.
+class CompressedSignalRepository : public ISignalRepository {
+    int block_size_;
+
+public:
+    // block_size - długość bloku w próbkach (ziarnistość dostępu swobodnego)
+    explicit CompressedSignalRepository(int block_size = 4096);
+
+    std::shared_ptr<SignalDataset> Load(const QString& source) override;
+
+    // Odczyt samego zakresu [from, from + count) próbek - czytane i dekodowane są tylko bloki, które go obejmują
+    std::shared_ptr<SignalDataset> LoadRange(const QString& source, int64_t from, int64_t count);
+
+    // Zapis zbioru danych. Zbiór w zapisie Int16 jest zapisywany bez strat; próbki float są najpierw
+    // kwantyzowane do int16 ze wzmocnieniem dobranym do amplitudy kanału.
+    bool Save(const SignalDataset& dataset, const QString& destination) const;
+};
+
+#endif //EKG_COMPRESSED_SIGNAL_REPOSITORY_H
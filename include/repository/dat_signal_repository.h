@@ -5,7 +5,16 @@
 #include <QString>
 
 class DATSignalRepository : public ISignalRepository {
+    bool independent_leads_only_;
+    SampleStorage storage_;
+
 public:
+    // independent_leads_only - dla standardowych zapisów 12-odprowadzeniowych dekoduje i przechowuje tylko
+    // odprowadzenia niezależne (I, II, V1..V6); III, aVR, aVL i aVF są wyliczane przez SignalDataset na żądanie.
+    // Zapisy o innym układzie odprowadzeń są wczytywane w całości.
+    // storage - Int16 lub Float16 przechowuje próbki w SignalDataset::compact (połowa pamięci float)
+    explicit DATSignalRepository(bool independent_leads_only = false, SampleStorage storage = SampleStorage::Float32);
+
     std::shared_ptr<SignalDataset> Load(const QString& filename) override;
 };
 
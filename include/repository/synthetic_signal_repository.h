@@ -0,0 +1,45 @@
+#ifndef EKG_SYNTHETIC_SIGNAL_REPOSITORY_H
+#define EKG_SYNTHETIC_SIGNAL_REPOSITORY_H
+#include <cstdint>
+#include <vector>
+
+#include "abstract/signal_repository.h"
+#include "../dto/synthetic_beat.h"
+#include "../dto/synthetic_ecg_options.h"
+#include <QString>
+
+// Generator syntetycznych 12-odprowadzeniowych zapisów EKG do testów skali i obciążenia (zapisy Holtera,
+// wysokie częstotliwości próbkowania).
+//
+// Model dynamiczny w duchu ECGSYN (McSharry i in., 2003): kolejne odstępy RR pochodzą z dwóch rezonatorów
+// AR(2) (pasma LF i HF), a faza w cyklu przesuwa się z prędkością 2π / RR. Załamki P, Q, R, S i T to zdarzenia
+// Gaussa w fazie - ich położenie względem R skaluje się z √RR (poza QRS). Każde zdarzenie ma wektor amplitud
+// w osiach X, Y, Z, więc model daje wektokardiogram, z którego odprowadzenia I, II i V1..V6 powstają macierzą
+// Dowera, a III, aVR, aVL i aVF z zależności Einthovena i Goldbergera.
+//
+// Harmonogram uderzeń powstaje sekwencyjnie, a próbki są liczone równolegle w blokach z własnym ziarnem
+// szumu, więc zapis dowolnej długości można wygenerować w pamięci (Load) albo strumieniowo do .dat/.hea
+// (Write) i w obu przypadkach jest identyczny.
+class SyntheticSignalRepository : public ISignalRepository {
+    SyntheticECGOptions options_;
+    SampleStorage storage_;
+    std::vector<SyntheticBeat> beats_;
+
+public:
+    explicit SyntheticSignalRepository(SyntheticECGOptions options = {},
+                                       SampleStorage storage = SampleStorage::Float32);
+
+    // Generuje zapis w pamięci; source służy tylko jako nazwa zapisu w komunikacie
+    std::shared_ptr<SignalDataset> Load(const QString& source) override;
+
+    // Zapisuje rekord WFDB (format 16) blokami, bez trzymania całego sygnału w pamięci.
+    // path - ścieżka pliku .dat lub .hea (albo bez rozszerzenia); powstają oba pliki.
+    bool Write(const QString& path);
+
+    // Adnotacje uderzeń ostatnio wygenerowanego zapisu (Load lub Write)
+    const std::vector<SyntheticBeat>& GetBeats() const { return beats_; }
+
+    int64_t SampleCount() const;
+};
+
+#endif //EKG_SYNTHETIC_SIGNAL_REPOSITORY_H
@@ -4,8 +4,10 @@
 #include "../../dto/signal_range.h"
 #include "../../dto/status.h"
 #include "../../dto/filter_method.h"
+#include "../../dto/signal_quality.h"
 #include "../../model/signal_datapoint.h"
 #include <QString>
+#include <cstdint>
 
 class IApplicationService {
 public:
@@ -14,15 +16,16 @@ public:
     // Ta metoda służy do podstawowego załadowania pliku za pomocą DAT
     virtual bool Load(const QString& filename) = 0;
 
-    // Ta metoda zwraca długość wektora wartości
-    virtual int GetLength() const = 0;
+    // Ta metoda zwraca długość wektora wartości (liczbę próbek)
+    virtual int64_t GetLength() const = 0;
 
     // Ta metoda zwraca częstotliwość zbioru danych w hertzach
     virtual int GetFrequency() const = 0;
 
     // W aplikacji istnieje koncept ViewRange - jest to zakres aktualnie wyświetlanego wykresu sygnału
-    // SignalRange.start wskazuje od którego indeksu wektora powinny być wyświetlane dane
-    // SignalRange.end wskazuje końcowy indeks
+    // SignalRange.start wskazuje od którego indeksu próbki powinny być wyświetlane dane
+    // SignalRange.end wskazuje indeks końcowy (bez niego). Zakres w sekundach lub znacznikach czasu
+    // tworzą SignalRange::FromSeconds i SignalRange::FromTimestamps.
     virtual SignalRange GetViewRange() const = 0;
 
     // Użytkownik powinien mieć możliwość ustawienia zakresu w trakcie korzystania z programu
@@ -43,6 +46,10 @@ public:
     // Uruchamia filtrowanie wedle zadanego algorytmu. Zwraca prawdę jeżeli filtrowanie się udało.
     // Po udanym wykonaniu tej metody, GetFilteredData() zwraca sensowne dane.
     virtual bool RunFiltering(FilterMethod method) = 0;
+
+    // Zwraca ocenę jakości sygnału (SQI) w segmentach. Segmenty oznaczone jako nieprzydatne
+    // są pomijane w dalszych etapach analizy i nie wchodzą do metryk HRV.
+    virtual SignalQuality GetSignalQuality() const = 0;
 };
 
 #endif //EKG_APPLICATION_SERVICE_H
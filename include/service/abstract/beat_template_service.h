@@ -0,0 +1,21 @@
+#ifndef EKG_BEAT_TEMPLATE_SERVICE_H
+#define EKG_BEAT_TEMPLATE_SERVICE_H
+#include <cstdint>
+#include <vector>
+
+#include "../../dto/beat_templates.h"
+#include "../../model/signal_datapoint.h"
+
+class IBeatTemplateService {
+public:
+    virtual ~IBeatTemplateService() = default;
+
+    // Wzorce uderzenia (średni i medianowy) dla wszystkich odprowadzeń z uderzeń wyrównanych do pików R.
+    // Zwykle podaje się tylko piki uderzeń prawidłowych, żeby pobudzenia dodatkowe nie zniekształciły wzorca.
+    // derived_limb_leads - układ kanałów jak w SignalDataset, zapisywany we wzorcach.
+    virtual BeatTemplates Compute(const std::vector<SignalDatapoint>& datapoints,
+                                  const std::vector<int64_t>& r_peaks, int frequency,
+                                  bool derived_limb_leads) = 0;
+};
+
+#endif //EKG_BEAT_TEMPLATE_SERVICE_H
@@ -3,12 +3,17 @@
 #include <vector>
 
 #include "../../model/signal_datapoint.h"
+#include "../../model/signal_dataset.h"
 
 class IFilterService {
 public:
     virtual ~IFilterService() = default;
 
     virtual std::vector<SignalDatapoint> Filter(const std::vector<SignalDatapoint>& values) = 0;
+
+    // Filtracja zbioru danych niezależnie od sposobu przechowywania próbek. Zapis 16-bitowy
+    // (SignalDataset::compact) jest czytany blokami i nie jest rozwijany w całości do float.
+    virtual std::vector<SignalDatapoint> Filter(const SignalDataset& dataset) = 0;
 };
 
 #endif //EKG_FILTER_SERVICE_H
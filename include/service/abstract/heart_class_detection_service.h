@@ -3,14 +3,19 @@
 #include <vector>
 
 #include "../../dto/heart_class_result.h"
+#include "../../model/beat_fiducials.h"
 #include "../../model/signal_datapoint.h"
 
 class IHeartClassDetectionService {
 public:
     virtual ~IHeartClassDetectionService() = default;
 
-    virtual HeartClassResult Detect(const std::vector<SignalDatapoint>& datapoints, int frequency) = 0;
+    // Klasyfikuje uderzenia wyznaczone przez detekcję załamków (kolejność jak w beats). run_starts - indeksy
+    // uderzeń rozpoczynających kolejne ciągłe odcinki sygnału (rosnąco, puste - jeden odcinek); odstępy RR
+    // i sekwencje rytmu nie przechodzą przez granice odcinków.
+    virtual HeartClassResult Detect(const std::vector<SignalDatapoint>& datapoints,
+                                    const std::vector<BeatFiducials>& beats, int frequency,
+                                    const std::vector<size_t>& run_starts) = 0;
 };
 
 #endif //EKG_HEART_CLASS_DETECTION_SERVICE_H
-
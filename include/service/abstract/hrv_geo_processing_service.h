@@ -1,13 +1,13 @@
 #ifndef EKG_HRV_GEO_PROCESSING_SERVICE_H
 #define EKG_HRV_GEO_PROCESSING_SERVICE_H
 #include "../../dto/hrv_geo_metrics.h"
-#include "../../model/r_peaks_annotated_signal_datapoint.h"
-#include <vector>
+#include "../../model/rr_series.h"
 
 class IHRVGeoProcessingService {
 public:
     virtual ~IHRVGeoProcessingService() = default;
-    virtual HRVGeoMetrics Process(const std::vector<RPeaksAnnotatedSignalDatapoint>& datapoints, int frequency) = 0;
+    // Histogram, indeks trójkątny, TINN i wykres Poincaré z odstępów NN serii
+    virtual HRVGeoMetrics Process(const RRSeries& rr_series) = 0;
 };
 
 #endif //EKG_HRV_GEO_PROCESSING_SERVICE_H
@@ -0,0 +1,14 @@
+#ifndef EKG_HRV_NONLINEAR_PROCESSING_SERVICE_H
+#define EKG_HRV_NONLINEAR_PROCESSING_SERVICE_H
+#include "../../dto/hrv_nonlinear_metrics.h"
+#include "../../model/rr_series.h"
+
+class IHRVNonlinearProcessingService {
+public:
+    virtual ~IHRVNonlinearProcessingService() = default;
+
+    // Entropia próbkowa, przybliżona i wieloskalowa serii odstępów NN
+    virtual HRVNonlinearMetrics Process(const RRSeries& rr_series) = 0;
+};
+
+#endif //EKG_HRV_NONLINEAR_PROCESSING_SERVICE_H
@@ -3,24 +3,39 @@
 #include <vector>
 
 #include "../../dto/hrv_time_metrics.h"
-#include "../../model/r_peaks_annotated_signal_datapoint.h"
-#include "../../model/signal_datapoint.h"
+#include "../../dto/hrv_window_series.h"
+#include "../../dto/hrv_spectrogram.h"
+#include "../../model/rr_series.h"
 
 class IHRVTimeProcessingService {
 public:
     virtual ~IHRVTimeProcessingService() = default;
 
-    // Przetwarza sygnał EKG i wykryte piki R w celu obliczenia metryk czasowych i częstotliwościowych HRV
-    // datapoints - przefiltrowany sygnał EKG
-    // r_peaks - wykryte piki R (może być pusty wektor, wtedy metoda zwróci domyślne wartości)
-    // frequency - częstotliwość próbkowania sygnału
+    // Oblicza metryki czasowe i częstotliwościowe HRV z serii odstępów RR
+    // rr_series - odstępy RR wyznaczone z wykrytych pików; używane są tylko odstępy NN
+    //             (seria bez odstępów NN daje domyślne wartości)
     // method - metoda estymacji widma (Classic Periodogram, Lomb-Scargle, Welch)
     virtual HRVTimeMetrics Process(
-        const std::vector<SignalDatapoint>& datapoints,
-        const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks,
-        int frequency,
+        const RRSeries& rr_series,
         HRVTimeMetrics::SpectralMethod method = HRVTimeMetrics::SpectralMethod::CLASSIC_PERIODOGRAM
     ) = 0;
+
+    // Metryki krótkoterminowe w oknach przesuwnych o długości window_seconds przesuwanych co step_seconds.
+    // Okna zaczynają się od pierwszego odstępu NN; uwzględniane są tylko okna mieszczące się w całości w serii.
+    virtual HRVWindowSeries ProcessWindowed(
+        const RRSeries& rr_series,
+        double window_seconds = 300.0,
+        double step_seconds = 300.0,
+        HRVTimeMetrics::SpectralMethod method = HRVTimeMetrics::SpectralMethod::CLASSIC_PERIODOGRAM
+    ) = 0;
+
+    // Spektrogram (STFT z oknem Hanna) przepróbkowanej serii odstępów NN oraz przebiegi mocy VLF/LF/HF
+    // window_seconds - długość okna analizy, step_seconds - przesunięcie kolejnych ramek
+    virtual HRVSpectrogram ComputeSpectrogram(
+        const RRSeries& rr_series,
+        double window_seconds = 120.0,
+        double step_seconds = 10.0
+    ) = 0;
 };
 
 #endif //EKG_HRV_TIME_PROCESSING_SERVICE_H
@@ -1,14 +1,18 @@
 #ifndef EKG_R_PEAKS_SERVICE_H
 #define EKG_R_PEAKS_SERVICE_H
+#include <memory>
 #include <vector>
 
+#include "streaming_r_peaks_detector.h"
 #include "../../model/r_peaks_annotated_signal_datapoint.h"
 #include "../../model/signal_datapoint.h"
 
 enum class RPeaksDetectionMethod {
     PanTompkins,
     Hilbert,
-    Wavelet
+    Wavelet,
+    // Fuzja wszystkich odprowadzeń (suma energii przestrzennej) - odporna na zaszumione lub odłączone II
+    MultiLead
 };
 
 class IRPeaksDetectionService {
@@ -19,6 +23,19 @@ public:
                                                                int frequency,
                                                                RPeaksDetectionMethod method = RPeaksDetectionMethod::PanTompkins) =
     0;
+
+    // Detekcja wielorozdzielcza: sygnał jest decymowany (z filtrem antyaliasingowym) do ~125 Hz,
+    // wybrana metoda działa na sygnale zdecymowanym, a położenie każdego piku jest doprecyzowane
+    // w małym oknie w pełnej rozdzielczości (na wierzchołek załamka R).
+    // Dla nagrań 500-1000 Hz jest kilkukrotnie szybsza od Detect() i nie drukuje raportu porównawczego.
+    virtual std::vector<RPeaksAnnotatedSignalDatapoint> DetectMultiRate(const std::vector<SignalDatapoint> &datapoints,
+                                                                        int frequency,
+                                                                        RPeaksDetectionMethod method = RPeaksDetectionMethod::PanTompkins) =
+    0;
+
+    // Tworzy detektor przyrostowy dla sygnału o zadanej częstotliwości próbkowania.
+    // Każdy strumień (nagranie, monitor) powinien mieć własny obiekt detektora.
+    virtual std::unique_ptr<IStreamingRPeaksDetector> CreateStreamingDetector(int frequency) = 0;
 };
 
 #endif //EKG_R_PEAKS_SERVICE_H
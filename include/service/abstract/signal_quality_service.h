@@ -0,0 +1,34 @@
+#ifndef EKG_SIGNAL_QUALITY_SERVICE_H
+#define EKG_SIGNAL_QUALITY_SERVICE_H
+#include <vector>
+
+#include "../../dto/signal_quality.h"
+#include "../../model/r_peaks_annotated_signal_datapoint.h"
+#include "../../model/signal_datapoint.h"
+#include "../../model/signal_dataset.h"
+
+class ISignalQualityService {
+public:
+    virtual ~ISignalQualityService() = default;
+
+    // Ocenia jakość sygnału w segmentach dla każdego odprowadzenia.
+    // datapoints - surowy sygnał EKG (odłączenie elektrody i nasycenie przetwornika widać przed filtracją)
+    // r_peaks - wynik detektora pików R: przefiltrowany sygnał z oznaczonymi uderzeniami, z którego liczona
+    //           jest kurtoza, udział szumu i zgodność odprowadzeń z uderzeniami (może być pusty wektor,
+    //           wtedy wszystkie miary liczone są na sygnale surowym)
+    // frequency - częstotliwość próbkowania sygnału
+    virtual SignalQuality Assess(
+        const std::vector<SignalDatapoint>& datapoints,
+        const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks,
+        int frequency
+    ) = 0;
+
+    // To samo dla zbioru danych niezależnie od sposobu przechowywania próbek - zapis 16-bitowy
+    // (SignalDataset::compact) jest czytany segmentami, bez rozwijania całego sygnału do float
+    virtual SignalQuality Assess(
+        const SignalDataset& dataset,
+        const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks
+    ) = 0;
+};
+
+#endif //EKG_SIGNAL_QUALITY_SERVICE_H
@@ -0,0 +1,32 @@
+#ifndef EKG_STREAMING_R_PEAKS_DETECTOR_H
+#define EKG_STREAMING_R_PEAKS_DETECTOR_H
+#include <cstdint>
+#include <vector>
+
+#include "../../model/signal_datapoint.h"
+
+// Detektor pików R działający przyrostowo (push): przyjmuje kolejne bloki próbek i zwraca
+// potwierdzone piki R. Stan filtrów, integratora i progów jest przenoszony między wywołaniami,
+// więc nagranie można przetwarzać kawałkami lub monitorować sygnał na żywo bez ponownej
+// detekcji na historii.
+class IStreamingRPeaksDetector {
+public:
+    virtual ~IStreamingRPeaksDetector() = default;
+
+    // Przetwarza kolejny blok próbek. Zwraca indeksy (liczone od początku strumienia)
+    // pików R, które zostały potwierdzone w trakcie tego bloku.
+    virtual std::vector<int64_t> Push(const std::vector<SignalDatapoint>& block) = 0;
+
+    // Kończy strumień - zwraca piki, które czekały jeszcze na potwierdzenie.
+    virtual std::vector<int64_t> Flush() = 0;
+
+    // Przywraca stan początkowy (nowy strumień).
+    virtual void Reset() = 0;
+
+    // Maksymalne opóźnienie decyzji w próbkach: pik R o indeksie n zostanie zwrócony najpóźniej
+    // przez Push() zawierający próbkę n + GetMaxDecisionDelay(). Nie dotyczy fazy uczenia
+    // progów na początku strumienia.
+    virtual int GetMaxDecisionDelay() const = 0;
+};
+
+#endif //EKG_STREAMING_R_PEAKS_DETECTOR_H
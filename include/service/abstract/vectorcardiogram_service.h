@@ -0,0 +1,23 @@
+#ifndef EKG_VECTORCARDIOGRAM_SERVICE_H
+#define EKG_VECTORCARDIOGRAM_SERVICE_H
+#include <vector>
+
+#include "../../dto/vectorcardiogram.h"
+#include "../../model/beat_fiducials.h"
+#include "../../model/signal_datapoint.h"
+
+class IVectorcardiogramService {
+public:
+    virtual ~IVectorcardiogramService() = default;
+
+    // Wektokardiogram z zapisu 12-odprowadzeniowego. derived_limb_leads - układ kanałów jak
+    // w SignalDataset (tylko I, II, V1..V6). Dla innego układu kanałów wynik jest pusty.
+    virtual Vectorcardiogram Derive(const std::vector<SignalDatapoint>& datapoints, int frequency,
+                                    bool derived_limb_leads) = 0;
+
+    // Przestrzenny kąt QRS-T [stopnie] między średnimi wektorami zespołów QRS i załamków T
+    // uderzeń z wyznaczonym załamkiem T. Przy braku takich uderzeń zwraca NaN.
+    virtual double SpatialQRSTAngle(const Vectorcardiogram& vcg, const std::vector<BeatFiducials>& beats) = 0;
+};
+
+#endif //EKG_VECTORCARDIOGRAM_SERVICE_H
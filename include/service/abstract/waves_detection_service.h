@@ -1,16 +1,25 @@
 #ifndef EKG_WAVES_DETECTION_SERVICE_H
 #define EKG_WAVES_DETECTION_SERVICE_H
+#include <cstdint>
 #include <vector>
 
-#include "../../model/wave_annotated_signal_datapoint.h"
+#include "../../model/beat_fiducials.h"
+#include "../../model/signal_datapoint.h"
 
 class IWavesDetectionService {
 public:
     virtual ~IWavesDetectionService() = default;
 
-    virtual std::vector<WaveAnnotatedSignalDatapoint> Detect(const std::vector<SignalDatapoint>& datapoints, int frequency) =
-    0;
+    // Wyznacza początki, szczyty i końce załamków P, zespołów QRS i załamków T dla każdego uderzenia
+    // datapoints - przefiltrowany sygnał EKG
+    // r_peaks - indeksy próbek wykrytych pików R (rosnąco), np. RRSeries::peaks
+    // frequency - częstotliwość próbkowania sygnału
+    // Zwraca jeden rekord na każdy pik R, w tej samej kolejności.
+    virtual std::vector<BeatFiducials> Detect(
+        const std::vector<SignalDatapoint>& datapoints,
+        const std::vector<int64_t>& r_peaks,
+        int frequency
+    ) = 0;
 };
 
 #endif //EKG_WAVES_DETECTION_SERVICE_H
-
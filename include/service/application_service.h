@@ -5,22 +5,40 @@
 #include "../repository/abstract/signal_repository.h"
 #include "abstract/filter_service.h"
 #include "abstract/r_peaks_detection_service.h"
+#include "abstract/signal_quality_service.h"
 #include "abstract/hrv_time_processing_service.h"
 #include "abstract/hrv_geo_processing_service.h"
 #include "abstract/hrv_dfa_processing_service.h"
+#include "abstract/hrv_nonlinear_processing_service.h"
 #include "abstract/waves_detection_service.h"
 #include "abstract/heart_class_detection_service.h"
+#include "abstract/beat_template_service.h"
+#include "abstract/vectorcardiogram_service.h"
+#include "../model/rr_series.h"
+#include "../model/beat_fiducials.h"
 
 class ApplicationService : public IApplicationService {
     std::shared_ptr<ISignalRepository> signal_repository_;
     std::shared_ptr<IFilterService> butterworth_filter_service_;
     std::shared_ptr<IFilterService> moving_average_filter_service_;
     std::shared_ptr<IRPeaksDetectionService> r_peaks_detection_service_;
+    std::shared_ptr<ISignalQualityService> signal_quality_service_;
     std::shared_ptr<IHRVTimeProcessingService> hrv_time_processing_service_;
     std::shared_ptr<IHRVGeoProcessingService> hrv_geo_processing_service_;
     std::shared_ptr<IHRVDFAProcessingService> hrv_dfa_processing_service_;
+    std::shared_ptr<IHRVNonlinearProcessingService> hrv_nonlinear_processing_service_;
     std::shared_ptr<IHeartClassDetectionService> heart_class_detection_service_;
     std::shared_ptr<IWavesDetectionService> waves_detection_service_;
+    std::shared_ptr<IBeatTemplateService> beat_template_service_;
+    std::shared_ptr<IVectorcardiogramService> vectorcardiogram_service_;
+
+    SignalQuality signal_quality_;
+    RRSeries rr_series_;
+    std::vector<BeatFiducials> beat_fiducials_;
+    HeartClassResult heart_class_result_;
+    BeatTemplates beat_templates_;
+    Vectorcardiogram vectorcardiogram_;
+    double spatial_qrs_t_angle_ = 0.0;
 
 public:
     explicit ApplicationService(
@@ -28,16 +46,20 @@ public:
         std::shared_ptr<IFilterService> butterworth_filter_service,
         std::shared_ptr<IFilterService> moving_average_filter_service,
         std::shared_ptr<IRPeaksDetectionService> r_peaks_detection_service,
+        std::shared_ptr<ISignalQualityService> signal_quality_service,
         std::shared_ptr<IHRVTimeProcessingService> hrv_time_processing_service,
         std::shared_ptr<IHRVGeoProcessingService> hrv_geo_processing_service,
         std::shared_ptr<IHRVDFAProcessingService> hrv_dfa_processing_service,
+        std::shared_ptr<IHRVNonlinearProcessingService> hrv_nonlinear_processing_service,
         std::shared_ptr<IWavesDetectionService> waves_detection_service,
-        std::shared_ptr<IHeartClassDetectionService> heart_class_detection_service
+        std::shared_ptr<IHeartClassDetectionService> heart_class_detection_service,
+        std::shared_ptr<IBeatTemplateService> beat_template_service,
+        std::shared_ptr<IVectorcardiogramService> vectorcardiogram_service
     );
 
     bool Load(const QString& filename) override;
 
-    int GetLength() const override;
+    int64_t GetLength() const override;
 
     SignalRange GetViewRange() const override;
 
@@ -52,6 +74,8 @@ public:
     bool RunFiltering(FilterMethod method) override;
 
     int GetFrequency() const override;
+
+    SignalQuality GetSignalQuality() const override;
 };
 
 #endif //EKG_APPLICATION_SERVICE_IMPL_H
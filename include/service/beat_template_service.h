@@ -0,0 +1,24 @@
+#ifndef EKG_BEAT_TEMPLATE_SERVICE_IMPL_H
+#define EKG_BEAT_TEMPLATE_SERVICE_IMPL_H
+
+#include "abstract/beat_template_service.h"
+
+// Uderzenia są kopiowane jednym przebiegiem po sygnale do macierzy próbka × uderzenie osobno dla każdego
+// odprowadzenia, więc wartości jednej próbki wzorca ze wszystkich uderzeń leżą obok siebie: średnia to
+// suma ciągłego wiersza, a mediana - wybór elementu środkowego (nth_element) w tym wierszu.
+class BeatTemplateService : public IBeatTemplateService {
+    double seconds_before_;
+    double seconds_after_;
+    size_t max_beats_;
+
+public:
+    // seconds_before / seconds_after - okno wzorca względem piku R,
+    // max_beats - przy dłuższych zapisach brane jest tyle uderzeń rozłożonych równomiernie w zapisie
+    explicit BeatTemplateService(double seconds_before = 0.3, double seconds_after = 0.5, size_t max_beats = 2048);
+
+    BeatTemplates Compute(const std::vector<SignalDatapoint>& datapoints,
+                          const std::vector<int64_t>& r_peaks, int frequency,
+                          bool derived_limb_leads) override;
+};
+
+#endif //EKG_BEAT_TEMPLATE_SERVICE_IMPL_H
@@ -4,8 +4,16 @@
 #include "abstract/filter_service.h"
 
 class ButterworthFilterService : public IFilterService {
+    int frequency_;
+
 public:
+    // frequency - częstotliwość próbkowania zakładana dla Filter(values);
+    // Filter(dataset) projektuje filtr dla częstotliwości zbioru danych
+    explicit ButterworthFilterService(int frequency = 500);
+
     std::vector<SignalDatapoint> Filter(const std::vector<SignalDatapoint>& values) override;
+
+    std::vector<SignalDatapoint> Filter(const SignalDataset& dataset) override;
 };
 
 #endif //EKG_BUTTERWORTH_FILTER_SERVICE_H
@@ -3,9 +3,20 @@
 
 #include "abstract/heart_class_detection_service.h"
 
+// Klasyfikacja uderzeń: cechy wszystkich uderzeń trafiają do jednej ciągłej macierzy (wiersz na uderzenie),
+// uderzenia są przyrostowo grupowane według morfologii, a następnie płaskie drzewo decyzyjne jest wykonywane
+// paczkami wierszy równolegle. Cechy: odstępy RR przed i po uderzeniu względem lokalnej mediany RR,
+// szerokość QRS, amplituda oraz korelacja wzorca grupy uderzenia z wzorcem grupy dominującej.
 class HeartClassDetectionService : public IHeartClassDetectionService {
+    int lead_;
+
 public:
-    HeartClassResult Detect(const std::vector<SignalDatapoint>& datapoints, int frequency) override;
+    // lead - indeks odprowadzenia, z którego brana jest morfologia (domyślnie II)
+    explicit HeartClassDetectionService(int lead = 1);
+
+    HeartClassResult Detect(const std::vector<SignalDatapoint>& datapoints,
+                            const std::vector<BeatFiducials>& beats, int frequency,
+                            const std::vector<size_t>& run_starts) override;
 };
 
 #endif //EKG_HEART_CLASS_DETECTION_SERVICE_IMPL_H
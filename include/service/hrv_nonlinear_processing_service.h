@@ -0,0 +1,19 @@
+#ifndef EKG_HRV_NONLINEAR_PROCESSING_SERVICE_IMPL_H
+#define EKG_HRV_NONLINEAR_PROCESSING_SERVICE_IMPL_H
+
+#include "abstract/hrv_nonlinear_processing_service.h"
+
+class HRVNonlinearProcessingService : public IHRVNonlinearProcessingService {
+    int embedding_dimension_;
+    double tolerance_;
+    int max_scale_;
+
+public:
+    // embedding_dimension - długość wzorca m, tolerance - r jako ułamek odchylenia standardowego serii,
+    // max_scale - największa skala entropii wieloskalowej
+    explicit HRVNonlinearProcessingService(int embedding_dimension = 2, double tolerance = 0.2, int max_scale = 20);
+
+    HRVNonlinearMetrics Process(const RRSeries& rr_series) override;
+};
+
+#endif //EKG_HRV_NONLINEAR_PROCESSING_SERVICE_IMPL_H
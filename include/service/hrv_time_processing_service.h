@@ -2,15 +2,31 @@
 #define EKG_HRV_TIME_PROCESSING_SERVICE_IMPL_H
 
 #include "abstract/hrv_time_processing_service.h"
+#include "../dto/spectral_options.h"
 
 class HRVTimeProcessingService : public IHRVTimeProcessingService {
+    SpectralOptions options_;
+
 public:
+    explicit HRVTimeProcessingService(SpectralOptions options = SpectralOptions());
+
     HRVTimeMetrics Process(
-        const std::vector<SignalDatapoint>& datapoints,
-        const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks,
-        int frequency,
+        const RRSeries& rr_series,
         HRVTimeMetrics::SpectralMethod method = HRVTimeMetrics::SpectralMethod::CLASSIC_PERIODOGRAM
     ) override;
+
+    HRVWindowSeries ProcessWindowed(
+        const RRSeries& rr_series,
+        double window_seconds = 300.0,
+        double step_seconds = 300.0,
+        HRVTimeMetrics::SpectralMethod method = HRVTimeMetrics::SpectralMethod::CLASSIC_PERIODOGRAM
+    ) override;
+
+    HRVSpectrogram ComputeSpectrogram(
+        const RRSeries& rr_series,
+        double window_seconds = 120.0,
+        double step_seconds = 10.0
+    ) override;
 };
 
 #endif //EKG_HRV_TIME_PROCESSING_SERVICE_IMPL_H
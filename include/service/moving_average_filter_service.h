@@ -6,6 +6,8 @@
 class MovingAverageFilterService : public IFilterService {
 public:
     std::vector<SignalDatapoint> Filter(const std::vector<SignalDatapoint>& values) override;
+
+    std::vector<SignalDatapoint> Filter(const SignalDataset& dataset) override;
 };
 
 #endif //EKG_MOVING_AVERAGE_FILTER_SERVICE_H
@@ -4,10 +4,22 @@
 #include "abstract/r_peaks_detection_service.h"
 
 class RPeaksDetectionService : public IRPeaksDetectionService {
+    bool comparison_report_;
+
 public:
+    // comparison_report - czy Detect() ma uruchamiać wszystkie metody i drukować raport porównawczy.
+    // Wyłączenie (np. w benchmarku) sprawia, że liczona jest tylko wybrana metoda.
+    explicit RPeaksDetectionService(bool comparison_report = true);
+
     std::vector<RPeaksAnnotatedSignalDatapoint>
     Detect(const std::vector<SignalDatapoint> &datapoints, int frequency,
            RPeaksDetectionMethod method = RPeaksDetectionMethod::PanTompkins) override;
+
+    std::vector<RPeaksAnnotatedSignalDatapoint>
+    DetectMultiRate(const std::vector<SignalDatapoint> &datapoints, int frequency,
+                    RPeaksDetectionMethod method = RPeaksDetectionMethod::PanTompkins) override;
+
+    std::unique_ptr<IStreamingRPeaksDetector> CreateStreamingDetector(int frequency) override;
 };
 
 #endif //EKG_R_PEAKS_DETECTION_SERVICE_H
@@ -0,0 +1,24 @@
+#ifndef EKG_SIGNAL_QUALITY_SERVICE_IMPL_H
+#define EKG_SIGNAL_QUALITY_SERVICE_IMPL_H
+
+#include "abstract/signal_quality_service.h"
+
+class SignalQualityService : public ISignalQualityService {
+    double segment_seconds_;
+
+public:
+    explicit SignalQualityService(double segment_seconds = 2.0);
+
+    SignalQuality Assess(
+        const std::vector<SignalDatapoint>& datapoints,
+        const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks,
+        int frequency
+    ) override;
+
+    SignalQuality Assess(
+        const SignalDataset& dataset,
+        const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks
+    ) override;
+};
+
+#endif //EKG_SIGNAL_QUALITY_SERVICE_IMPL_H
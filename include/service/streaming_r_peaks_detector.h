@@ -0,0 +1,83 @@
+#ifndef EKG_STREAMING_R_PEAKS_DETECTOR_IMPL_H
+#define EKG_STREAMING_R_PEAKS_DETECTOR_IMPL_H
+
+#include "abstract/streaming_r_peaks_detector.h"
+
+// Przyrostowy wariant Pan-Tompkinsa: pasmowy 5-15 Hz (dwie sekcje Butterwortha), pochodna,
+// kwadrat, całkowanie w oknie 150 ms i adaptacyjne progi SPKI/NPKI.
+// Kandydat na zespół QRS jest potwierdzany, gdy przez 120 ms nie pojawi się wyższe maksimum
+// sygnału scałkowanego, więc opóźnienie decyzji wynosi co najwyżej 150 + 120 + 20 ms < 300 ms.
+// Przez pierwsze 2 s progi są dopiero uczone - piki z tego okresu są zwracane po jego końcu.
+class StreamingRPeaksDetector : public IStreamingRPeaksDetector {
+    struct Biquad {
+        double b0 = 0.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+        double x1 = 0.0, x2 = 0.0, y1 = 0.0, y2 = 0.0;
+
+        double Step(double x0);
+    };
+
+    struct LocalMax {
+        double value;
+        int64_t mwi_index;
+        int64_t r_index;
+    };
+
+    int frequency_;
+    int lead_;
+
+    int integration_window_;
+    int confirm_window_;
+    int filter_delay_;
+    int refractory_;
+    int learning_samples_;
+
+    Biquad high_pass_;
+    Biquad low_pass_;
+
+    // Historia sygnału po filtrze pasmowym (do lokalizacji R) oraz po podniesieniu do kwadratu
+    // (do okna całkującego) - bufory cykliczne.
+    std::vector<double> filtered_history_;
+    std::vector<double> squared_history_;
+    double derivative_state_[4] = {0.0, 0.0, 0.0, 0.0};
+    double integrator_sum_ = 0.0;
+    double mwi_prev_ = 0.0;
+    double mwi_prev2_ = 0.0;
+
+    int64_t sample_index_ = 0;
+
+    bool learning_ = true;
+    double learning_max_ = 0.0;
+    double learning_sum_ = 0.0;
+    std::vector<LocalMax> learning_maxima_;
+
+    double spki_ = 0.0;
+    double npki_ = 0.0;
+    int64_t last_r_index_ = -1;
+    bool has_candidate_ = false;
+    LocalMax candidate_{};
+
+    void ProcessSample(double x, std::vector<int64_t>& confirmed);
+
+    void HandleLocalMax(const LocalMax& local_max, int64_t now, std::vector<int64_t>& confirmed);
+
+    void ConfirmCandidateIfDue(int64_t now, std::vector<int64_t>& confirmed);
+
+    void FinishLearning(std::vector<int64_t>& confirmed);
+
+    int64_t LocateR(int64_t mwi_index) const;
+
+    double Threshold() const;
+
+public:
+    explicit StreamingRPeaksDetector(int frequency, int lead = 1);
+
+    std::vector<int64_t> Push(const std::vector<SignalDatapoint>& block) override;
+
+    std::vector<int64_t> Flush() override;
+
+    void Reset() override;
+
+    int GetMaxDecisionDelay() const override;
+};
+
+#endif //EKG_STREAMING_R_PEAKS_DETECTOR_IMPL_H
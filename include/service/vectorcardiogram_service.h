@@ -0,0 +1,18 @@
+#ifndef EKG_VECTORCARDIOGRAM_SERVICE_IMPL_H
+#define EKG_VECTORCARDIOGRAM_SERVICE_IMPL_H
+
+#include "abstract/vectorcardiogram_service.h"
+
+// Wektokardiogram metodą odwrotnej macierzy Dowera (Edenbrandt, Pahlm 1988): X, Y, Z są kombinacjami
+// liniowymi ośmiu niezależnych odprowadzeń V1..V6, I, II. Sygnał jest przetwarzany blokami próbek:
+// blok jest przepisywany do ośmiu ciągłych buforów odprowadzeń, a mnożenie przez macierz 3 × 8
+// wykonywane jest pętlami po próbkach, które kompilator wektoryzuje. Bloki są liczone równolegle.
+class VectorcardiogramService : public IVectorcardiogramService {
+public:
+    Vectorcardiogram Derive(const std::vector<SignalDatapoint>& datapoints, int frequency,
+                            bool derived_limb_leads) override;
+
+    double SpatialQRSTAngle(const Vectorcardiogram& vcg, const std::vector<BeatFiducials>& beats) override;
+};
+
+#endif //EKG_VECTORCARDIOGRAM_SERVICE_IMPL_H
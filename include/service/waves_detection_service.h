@@ -4,8 +4,17 @@
 #include "abstract/waves_detection_service.h"
 
 class WavesDetectionService : public IWavesDetectionService {
+    int lead_;
+
 public:
-    std::vector<WaveAnnotatedSignalDatapoint> Detect(const std::vector<SignalDatapoint>& datapoints, int frequency) override;
+    // lead - odprowadzenie używane do wyznaczania załamków (domyślnie II, jak w detektorach pików R)
+    explicit WavesDetectionService(int lead = 1);
+
+    std::vector<BeatFiducials> Detect(
+        const std::vector<SignalDatapoint>& datapoints,
+        const std::vector<int64_t>& r_peaks,
+        int frequency
+    ) override;
 };
 
 #endif //EKG_WAVES_DETECTION_SERVICE_IMPL_H
@@ -0,0 +1,47 @@
+#ifndef EKG_ALIGNED_ALLOCATOR_H
+#define EKG_ALIGNED_ALLOCATOR_H
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Alokator dla std::vector z początkiem bufora wyrównanym do Alignment bajtów (std::allocator gwarantuje
+// tylko alignof(T)). Przy wierszach o długości wielokrotności Alignment każdy wiersz macierzy zaczyna się
+// na granicy Alignment, więc wektoryzowane pętle po wierszu nie przekraczają linii pamięci podręcznej.
+template<typename T, size_t Alignment>
+class AlignedAllocator {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "Alignment must be a power of two not smaller than alignof(T)");
+
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Alignment>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {
+    }
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* pointer, size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+template<typename T, size_t Alignment>
+using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+#endif //EKG_ALIGNED_ALLOCATOR_H
@@ -0,0 +1,104 @@
+#ifndef EKG_BIT_STREAM_H
+#define EKG_BIT_STREAM_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Liczba wiodących zer 64-bitowej wartości niezerowej
+inline int CountLeadingZeros(uint64_t value) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanReverse64(&index, value);
+    return 63 - static_cast<int>(index);
+#else
+    return __builtin_clzll(value);
+#endif
+}
+
+// Zapis strumienia bitów od najstarszego bitu, bajty dopisywane na koniec bufora
+class BitWriter {
+    std::vector<uint8_t>& out_;
+    uint64_t buffer_ = 0;
+    int bits_ = 0; // liczba bitów czekających w buffer_ (najmłodsze bity)
+
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {
+    }
+
+    // Dopisuje count (<= 32) najmłodszych bitów value
+    void Write(uint32_t value, int count) {
+        if (count == 0) return;
+        buffer_ = (buffer_ << count) | (value & (0xffffffffu >> (32 - count)));
+        bits_ += count;
+        while (bits_ >= 8) {
+            bits_ -= 8;
+            out_.push_back(static_cast<uint8_t>(buffer_ >> bits_));
+        }
+    }
+
+    // count jedynek (count <= 32)
+    void WriteOnes(int count) {
+        if (count > 0) Write(0xffffffffu, count);
+    }
+
+    // Dopełnia ostatni bajt zerami
+    void Flush() {
+        if (bits_ > 0) {
+            out_.push_back(static_cast<uint8_t>(buffer_ << (8 - bits_)));
+            bits_ = 0;
+        }
+    }
+};
+
+// Odczyt strumienia zapisanego przez BitWriter. Za końcem danych zwraca zera.
+class BitReader {
+    const uint8_t* data_;
+    const uint8_t* end_;
+    uint64_t buffer_ = 0; // bity do odczytu wyrównane do najstarszego bitu
+    int bits_ = 0;
+
+    void Refill() {
+        while (bits_ <= 56) {
+            const uint64_t byte = data_ < end_ ? *data_++ : 0;
+            buffer_ |= byte << (56 - bits_);
+            bits_ += 8;
+        }
+    }
+
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), end_(data + size) {
+        Refill();
+    }
+
+    // Odczyt count (<= 32) bitów
+    uint32_t Read(int count) {
+        if (count == 0) return 0;
+        const uint32_t value = static_cast<uint32_t>(buffer_ >> (64 - count));
+        buffer_ <<= count;
+        bits_ -= count;
+        Refill();
+        return value;
+    }
+
+    // Liczba kolejnych jedynek (najwyżej limit, <= 56), pomija zero kończące serię, jeśli seria jest krótsza od limitu
+    int ReadOnes(int limit) {
+        const uint64_t inverted = ~buffer_;
+        int ones = inverted == 0 ? 64 : CountLeadingZeros(inverted);
+        if (ones >= limit) {
+            ones = limit;
+            buffer_ <<= ones;
+            bits_ -= ones;
+        } else {
+            buffer_ <<= ones + 1;
+            bits_ -= ones + 1;
+        }
+        Refill();
+        return ones;
+    }
+};
+
+#endif //EKG_BIT_STREAM_H
@@ -0,0 +1,59 @@
+#ifndef EKG_HALF_FLOAT_H
+#define EKG_HALF_FLOAT_H
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// Konwersje IEEE 754 binary16 <-> binary32 bez zależności od sprzętowego typu half.
+// Odczyt jest bezgałęziowy (pętla po blokach wektoryzuje się), zapis zaokrągla do najbliższej (do parzystej).
+
+inline float HalfToFloat(uint16_t half) {
+    const uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+    const uint32_t magnitude = half & 0x7fffu;
+
+    // Wykładnik i mantysa przesunięte na pozycje float i przeskalowane o 2^112 - to samo mnożenie
+    // normalizuje liczby podnormalne half
+    uint32_t bits = magnitude << 13;
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    value *= 5.192296858534828e+33f; // 2^112
+
+    // Nieskończoność i NaN: wykładnik 31 przechodzi na 255
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = magnitude >= 0x7c00u ? (0x7f800000u | (magnitude << 13)) : bits;
+    bits |= sign;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+inline uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000u);
+    const uint32_t magnitude = bits & 0x7fffffffu;
+
+    if (magnitude >= 0x7f800000u) // nieskończoność lub NaN (NaN zachowuje bit ciszy)
+        return sign | 0x7c00u | (magnitude > 0x7f800000u ? 0x200u : 0u);
+    if (magnitude >= 0x477ff000u) // powyżej największej wartości half po zaokrągleniu
+        return sign | 0x7c00u;
+    if (magnitude < 0x38800000u) { // podnormalne half (lub zero)
+        if (magnitude < 0x33000000u) return sign; // mniej niż połowa najmniejszej podnormalnej
+        const uint32_t mantissa = (magnitude & 0x7fffffu) | 0x800000u;
+        const int shift = 126 - static_cast<int>(magnitude >> 23);
+        const uint32_t rounded = mantissa >> shift;
+        const uint32_t remainder = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        return sign | static_cast<uint16_t>(rounded + (remainder > halfway || (remainder == halfway && (rounded & 1))));
+    }
+    // Liczby normalne: zmiana przesunięcia wykładnika 127 -> 15 i zaokrąglenie 13 odrzucanych bitów
+    const uint32_t rebased = magnitude - 0x38000000u;
+    const uint32_t rounded = (rebased + 0x0fffu + ((rebased >> 13) & 1u)) >> 13;
+    return sign | static_cast<uint16_t>(rounded);
+}
+
+// Odczyt bloku wartości half
+inline void HalfToFloat(const uint16_t* in, float* out, size_t count) {
+    for (size_t i = 0; i < count; ++i) out[i] = HalfToFloat(in[i]);
+}
+
+#endif //EKG_HALF_FLOAT_H
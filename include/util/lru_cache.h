@@ -0,0 +1,48 @@
+#ifndef EKG_LRU_CACHE_H
+#define EKG_LRU_CACHE_H
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+// Bezpieczna wątkowo pamięć podręczna obiektów współdzielonych (plany FFT, okna) o ograniczonej
+// liczbie wpisów. Po przekroczeniu capacity usuwany jest wpis najdawniej używany. Zwracany wskaźnik
+// współdzieli obiekt, więc pozostaje ważny także po usunięciu wpisu.
+template<typename Key, typename Value>
+class LruCache {
+    using Entry = std::pair<Key, std::shared_ptr<const Value>>;
+
+    size_t capacity_;
+    std::mutex mutex_;
+    std::list<Entry> entries_; // od ostatnio używanego
+    std::map<Key, typename std::list<Entry>::iterator> index_;
+
+public:
+    explicit LruCache(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {
+    }
+
+    // Obiekt dla klucza; przy braku wpisu tworzony przez create() i zapamiętywany
+    template<typename Create>
+    std::shared_ptr<const Value> Get(const Key& key, Create&& create) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(key);
+        if (it != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+
+        std::shared_ptr<const Value> value = create();
+        entries_.emplace_front(key, value);
+        index_.emplace(key, entries_.begin());
+        if (entries_.size() > capacity_) {
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        return value;
+    }
+};
+
+#endif //EKG_LRU_CACHE_H
@@ -0,0 +1,48 @@
+#ifndef EKG_PARALLEL_FOR_H
+#define EKG_PARALLEL_FOR_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// Dzieli zakres [0, count) na fragmenty po co najwyżej grain elementów i wykonuje body(from, to)
+// równolegle na wątkach sprzętowych. Wątki pobierają kolejne fragmenty z jednego licznika, więc
+// nierówny koszt fragmentów się wyrównuje. Stan roboczy (bufory, plany) warto tworzyć raz na
+// fragment wewnątrz body. Przy jednym fragmencie lub jednym rdzeniu body wykonuje się w bieżącym wątku.
+template<typename Body>
+void ParallelForRange(size_t count, size_t grain, Body&& body) {
+    if (count == 0) return;
+    grain = std::max<size_t>(1, grain);
+    const size_t chunks = (count + grain - 1) / grain;
+    const size_t threads = std::min<size_t>(chunks, std::max(1u, std::thread::hardware_concurrency()));
+
+    if (threads <= 1) {
+        body(size_t{0}, count);
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t chunk = next++; chunk < chunks; chunk = next++) {
+            const size_t from = chunk * grain;
+            body(from, std::min(count, from + grain));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (size_t t = 1; t < threads; ++t) pool.emplace_back(worker);
+    worker();
+    for (auto& thread : pool) thread.join();
+}
+
+// Wywołuje body(i) dla każdego i z [0, count), równolegle
+template<typename Body>
+void ParallelFor(size_t count, Body&& body, size_t grain = 1) {
+    ParallelForRange(count, grain, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) body(i);
+    });
+}
+
+#endif //EKG_PARALLEL_FOR_H
@@ -0,0 +1,71 @@
+#ifndef EKG_SAMPLE_TIME_H
+#define EKG_SAMPLE_TIME_H
+#include <cmath>
+#include <cstdint>
+
+// Przeliczenia między indeksem próbki (int64_t) a czasem. Indeksy i znaczniki czasu są liczbami całkowitymi,
+// więc wielodniowe zapisy z wysoką częstotliwością próbkowania są adresowane dokładnie - float przestaje
+// rozróżniać kolejne próbki powyżej 2^24 (ok. 9 h przy 500 Hz).
+// Znaczniki bezwzględne to mikrosekundy od 1970-01-01 00:00:00 UTC.
+
+constexpr int64_t MICROSECONDS_PER_SECOND = 1000000;
+
+// Dzielenie całkowite zaokrąglające w dół także dla ujemnej dzielnej
+inline int64_t FloorDivide(int64_t numerator, int64_t denominator) {
+    const int64_t quotient = numerator / denominator;
+    return (numerator % denominator != 0 && (numerator < 0) != (denominator < 0)) ? quotient - 1 : quotient;
+}
+
+inline double SampleToSeconds(int64_t sample, int frequency) {
+    return static_cast<double>(sample) / frequency;
+}
+
+// Najbliższa próbka dla chwili podanej w sekundach od początku zapisu
+inline int64_t SecondsToSample(double seconds, int frequency) {
+    return std::llround(seconds * frequency);
+}
+
+// Przesunięcie próbki względem początku zapisu w mikrosekundach (obcięte do pełnej mikrosekundy)
+inline int64_t SampleToMicroseconds(int64_t sample, int frequency) {
+    // sample · 10^6 mieści się w int64_t do ~9.2 · 10^12 próbek (ok. 29 lat przy 10 kHz)
+    return FloorDivide(sample * MICROSECONDS_PER_SECOND, frequency);
+}
+
+// Najbliższa próbka dla przesunięcia w mikrosekundach od początku zapisu
+inline int64_t MicrosecondsToSample(int64_t microseconds, int frequency) {
+    return FloorDivide(microseconds * frequency + MICROSECONDS_PER_SECOND / 2, MICROSECONDS_PER_SECOND);
+}
+
+// Znacznik bezwzględny próbki dla zapisu rozpoczętego w chwili start_us
+inline int64_t SampleToTimestamp(int64_t sample, int frequency, int64_t start_us) {
+    return start_us + SampleToMicroseconds(sample, frequency);
+}
+
+inline int64_t TimestampToSample(int64_t timestamp_us, int frequency, int64_t start_us) {
+    return MicrosecondsToSample(timestamp_us - start_us, frequency);
+}
+
+// Liczba dni od 1970-01-01 dla daty kalendarza gregoriańskiego (month 1..12)
+inline int64_t DaysFromCivil(int64_t year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = FloorDivide(year, 400);
+    const int64_t year_of_era = year - era * 400;
+    const int64_t day_of_year = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int64_t day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + day_of_era - 719468;
+}
+
+// Odwrotność DaysFromCivil
+inline void CivilFromDays(int64_t days, int64_t& year, int& month, int& day) {
+    days += 719468;
+    const int64_t era = FloorDivide(days, 146097);
+    const int64_t day_of_era = days - era * 146097;
+    const int64_t year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+    const int64_t day_of_year = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    const int64_t month_index = (5 * day_of_year + 2) / 153;
+    day = static_cast<int>(day_of_year - (153 * month_index + 2) / 5 + 1);
+    month = static_cast<int>(month_index < 10 ? month_index + 3 : month_index - 9);
+    year = year_of_era + era * 400 + (month <= 2);
+}
+
+#endif //EKG_SAMPLE_TIME_H
@@ -13,19 +13,25 @@
 #include "include/service/butterworth_filter_service.h"
 #include "include/service/moving_average_filter_service.h"
 #include "include/service/r_peaks_detection_service.h"
+#include "include/service/signal_quality_service.h"
 #include "include/service/hrv_time_processing_service.h"
 #include "include/service/hrv_geo_processing_service.h"
 #include "include/service/hrv_dfa_processing_service.h"
+#include "include/service/hrv_nonlinear_processing_service.h"
 #include "include/service/heart_class_detection_service.h"
 #include "include/service/waves_detection_service.h"
+#include "include/service/beat_template_service.h"
+#include "include/service/vectorcardiogram_service.h"
 
 int main(int argc, char *argv[]) {
-    std::shared_ptr<ISignalRepository> signal_repository = std::make_shared<DATSignalRepository>();
+    // Standardowe zapisy 12-odprowadzeniowe: tylko 8 odprowadzeń niezależnych, III, aVR, aVL i aVF na żądanie
+    std::shared_ptr<ISignalRepository> signal_repository = std::make_shared<DATSignalRepository>(true);
 
     std::shared_ptr<IFilterService> butterworth_filter_service = std::make_shared<ButterworthFilterService>();
     std::shared_ptr<IFilterService> moving_average_filter_service = std::make_shared<MovingAverageFilterService>();
 
     std::shared_ptr<IRPeaksDetectionService> r_peaks_detection_service = std::make_shared<RPeaksDetectionService>();
+    std::shared_ptr<ISignalQualityService> signal_quality_service = std::make_shared<SignalQualityService>();
 
     std::shared_ptr<IHRVTimeProcessingService> hrv_time_processing_service = std::make_shared<
         HRVTimeProcessingService>();
@@ -33,19 +39,28 @@ int main(int argc, char *argv[]) {
 
     std::shared_ptr<IWavesDetectionService> waves_detection_service = std::make_shared<WavesDetectionService>();
     std::shared_ptr<IHRVDFAProcessingService> hrv_dfa_processing_service = std::make_shared<HRVDFAProcessingService>();
+    std::shared_ptr<IHRVNonlinearProcessingService> hrv_nonlinear_processing_service = std::make_shared<
+        HRVNonlinearProcessingService>();
     std::shared_ptr<IHeartClassDetectionService> heart_class_detection_service = std::make_shared<
         HeartClassDetectionService>();
+    std::shared_ptr<IBeatTemplateService> beat_template_service = std::make_shared<BeatTemplateService>();
+    std::shared_ptr<IVectorcardiogramService> vectorcardiogram_service = std::make_shared<
+        VectorcardiogramService>();
 
     std::shared_ptr<IApplicationService> application_service = std::make_shared<ApplicationService>(
         signal_repository,
         butterworth_filter_service,
         moving_average_filter_service,
         r_peaks_detection_service,
+        signal_quality_service,
         hrv_time_processing_service,
         hrv_geo_processing_service,
         hrv_dfa_processing_service,
+        hrv_nonlinear_processing_service,
         waves_detection_service,
-        heart_class_detection_service
+        heart_class_detection_service,
+        beat_template_service,
+        vectorcardiogram_service
     );
 
     QApplication a(argc, argv);
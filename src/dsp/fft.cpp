@@ -0,0 +1,242 @@
+#include "../../include/dsp/fft.h"
+#include <cmath>
+
+#include "../../include/util/lru_cache.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+using Complex = std::complex<double>;
+
+namespace {
+    // Liczba zapamiętanych planów każdego rodzaju. Długości segmentów zależą od danych (okna HRV,
+    // Welch, spektrogram), więc pamięć podręczna jest ograniczona, a nie rośnie z każdą nową długością.
+    constexpr size_t PLAN_CACHE_SIZE = 16;
+
+    template<typename Plan>
+    std::shared_ptr<const Plan> CachedPlan(size_t n) {
+        static LruCache<size_t, Plan> cache(PLAN_CACHE_SIZE);
+        return cache.Get(n, [n]() { return std::make_shared<const Plan>(n); });
+    }
+}
+
+// ===============================================================
+// ========================= COMPLEX FFT ==========================
+// ===============================================================
+ComplexFFT::ComplexFFT(size_t n) : n_(n) {
+    twiddles_.resize(n);
+    for (size_t k = 0; k < n; ++k) {
+        const double phase = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(n);
+        twiddles_[k] = Complex(std::cos(phase), std::sin(phase));
+    }
+
+    // Rozkład na czynniki: najpierw 4, potem 2, 3, 5, 7, ...
+    size_t rest = n;
+    size_t p = 4;
+    const size_t floor_sqrt = static_cast<size_t>(std::floor(std::sqrt(static_cast<double>(n))));
+    while (rest > 1) {
+        while (rest % p) {
+            switch (p) {
+                case 4: p = 2;
+                    break;
+                case 2: p = 3;
+                    break;
+                default: p += 2;
+                    break;
+            }
+            if (p > floor_sqrt) p = rest;
+        }
+        rest /= p;
+        factors_.push_back(p);
+        factors_.push_back(rest);
+    }
+    if (factors_.empty()) {
+        factors_.push_back(1);
+        factors_.push_back(1);
+    }
+}
+
+void ComplexFFT::Forward(const Complex *in, Complex *out) const {
+    if (n_ == 0) return;
+    if (n_ == 1) {
+        out[0] = in[0];
+        return;
+    }
+    Work(out, in, 1, factors_.data());
+}
+
+void ComplexFFT::Work(Complex *out, const Complex *in, size_t fstride, const size_t *factors) const {
+    const size_t p = factors[0];
+    const size_t m = factors[1];
+    Complex *out_begin = out;
+    const Complex *out_end = out + p * m;
+
+    if (m == 1) {
+        do {
+            *out = *in;
+            in += fstride;
+        } while (++out != out_end);
+    } else {
+        do {
+            Work(out, in, fstride * p, factors + 2);
+            in += fstride;
+        } while ((out += m) != out_end);
+    }
+
+    out = out_begin;
+    switch (p) {
+        case 2: Butterfly2(out, fstride, m);
+            break;
+        case 3: Butterfly3(out, fstride, m);
+            break;
+        case 4: Butterfly4(out, fstride, m);
+            break;
+        default: ButterflyGeneric(out, fstride, m, p);
+            break;
+    }
+}
+
+void ComplexFFT::Butterfly2(Complex *out, size_t fstride, size_t m) const {
+    Complex *out2 = out + m;
+    for (size_t k = 0; k < m; ++k) {
+        const Complex t = out2[k] * twiddles_[k * fstride];
+        out2[k] = out[k] - t;
+        out[k] += t;
+    }
+}
+
+void ComplexFFT::Butterfly3(Complex *out, size_t fstride, size_t m) const {
+    const double epi3 = twiddles_[fstride * m].imag();
+    for (size_t k = 0; k < m; ++k) {
+        const Complex s1 = out[k + m] * twiddles_[k * fstride];
+        const Complex s2 = out[k + 2 * m] * twiddles_[2 * k * fstride];
+        const Complex s3 = s1 + s2;
+        const Complex s0 = (s1 - s2) * epi3;
+
+        const Complex base = out[k] - s3 * 0.5;
+        out[k] += s3;
+        out[k + 2 * m] = Complex(base.real() + s0.imag(), base.imag() - s0.real());
+        out[k + m] = Complex(base.real() - s0.imag(), base.imag() + s0.real());
+    }
+}
+
+void ComplexFFT::Butterfly4(Complex *out, size_t fstride, size_t m) const {
+    for (size_t k = 0; k < m; ++k) {
+        const Complex s0 = out[k + m] * twiddles_[k * fstride];
+        const Complex s1 = out[k + 2 * m] * twiddles_[2 * k * fstride];
+        const Complex s2 = out[k + 3 * m] * twiddles_[3 * k * fstride];
+
+        const Complex s5 = out[k] - s1;
+        out[k] += s1;
+        const Complex s3 = s0 + s2;
+        const Complex s4 = s0 - s2;
+
+        out[k + 2 * m] = out[k] - s3;
+        out[k] += s3;
+        out[k + m] = Complex(s5.real() + s4.imag(), s5.imag() - s4.real());
+        out[k + 3 * m] = Complex(s5.real() - s4.imag(), s5.imag() + s4.real());
+    }
+}
+
+void ComplexFFT::ButterflyGeneric(Complex *out, size_t fstride, size_t m, size_t p) const {
+    std::vector<Complex> scratch(p);
+    for (size_t u = 0; u < m; ++u) {
+        size_t k = u;
+        for (size_t q1 = 0; q1 < p; ++q1) {
+            scratch[q1] = out[k];
+            k += m;
+        }
+
+        k = u;
+        for (size_t q1 = 0; q1 < p; ++q1) {
+            size_t twidx = 0;
+            out[k] = scratch[0];
+            for (size_t q = 1; q < p; ++q) {
+                twidx += fstride * k;
+                if (twidx >= n_) twidx -= n_;
+                out[k] += scratch[q] * twiddles_[twidx];
+            }
+            k += m;
+        }
+    }
+}
+
+std::shared_ptr<const ComplexFFT> ComplexFFT::ForSize(size_t n) {
+    return CachedPlan<ComplexFFT>(n);
+}
+
+// ===============================================================
+// ========================== REAL FFT ============================
+// ===============================================================
+RealFFT::RealFFT(size_t n) : n_(n) {
+    if (n % 2 == 0 && n >= 2) {
+        const size_t half = n / 2;
+        half_ = ComplexFFT::ForSize(half);
+        super_twiddles_.resize(half / 2 + 1);
+        for (size_t k = 0; k < super_twiddles_.size(); ++k) {
+            const double phase = -M_PI * (static_cast<double>(k + 1) / static_cast<double>(half) + 0.5);
+            super_twiddles_[k] = Complex(std::cos(phase), std::sin(phase));
+        }
+    } else if (n > 0) {
+        full_ = ComplexFFT::ForSize(n);
+    }
+}
+
+void RealFFT::Forward(const double *input, Complex *output, std::vector<Complex> &workspace) const {
+    if (n_ == 0) return;
+
+    if (!half_) {
+        // Nieparzysta długość - zwykła transformata zespolona
+        workspace.resize(2 * n_);
+        for (size_t i = 0; i < n_; ++i)
+            workspace[i] = Complex(input[i], 0.0);
+        full_->Forward(workspace.data(), workspace.data() + n_);
+        for (size_t k = 0; k < SpectrumSize(); ++k)
+            output[k] = workspace[n_ + k];
+        return;
+    }
+
+    // Próbki parzyste i nieparzyste jako część rzeczywista i urojona sygnału o długości n/2
+    const size_t half = n_ / 2;
+    workspace.resize(2 * half);
+    Complex *packed = workspace.data();
+    Complex *z = workspace.data() + half;
+    for (size_t i = 0; i < half; ++i)
+        packed[i] = Complex(input[2 * i], input[2 * i + 1]);
+    half_->Forward(packed, z);
+
+    output[0] = Complex(z[0].real() + z[0].imag(), 0.0);
+    output[half] = Complex(z[0].real() - z[0].imag(), 0.0);
+
+    for (size_t k = 1; k <= half / 2; ++k) {
+        const Complex fpk = z[k];
+        const Complex fpnk = std::conj(z[half - k]);
+        const Complex f1k = fpk + fpnk;
+        const Complex f2k = fpk - fpnk;
+        const Complex tw = f2k * super_twiddles_[k - 1];
+
+        output[k] = 0.5 * (f1k + tw);
+        output[half - k] = 0.5 * std::conj(f1k - tw);
+    }
+}
+
+void RealFFT::Forward(const double *input, Complex *output) const {
+    std::vector<Complex> workspace;
+    Forward(input, output, workspace);
+}
+
+std::shared_ptr<const RealFFT> RealFFT::ForSize(size_t n) {
+    return CachedPlan<RealFFT>(n);
+}
+
+size_t RealFFT::NextFastSize(size_t n) {
+    if (n <= 2) return 2;
+    for (size_t m = n + (n % 2);; m += 2) {
+        size_t r = m;
+        while (r % 2 == 0) r /= 2;
+        while (r % 3 == 0) r /= 3;
+        while (r % 5 == 0) r /= 5;
+        if (r == 1) return m;
+    }
+}
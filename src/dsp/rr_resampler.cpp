@@ -0,0 +1,72 @@
+#include "../../include/dsp/rr_resampler.h"
+#include <algorithm>
+#include <cmath>
+
+RRResampler::RRResampler(double sampling_rate, ResamplingMode mode)
+    : sampling_rate_(sampling_rate), mode_(mode) {
+}
+
+void RRResampler::PrepareSpline(const std::vector<double> &times, const std::vector<double> &values) {
+    // Układ trójprzekątniowy na drugie pochodne naturalnego splajnu (algorytm Thomasa)
+    const size_t n = times.size();
+    second_derivatives_.assign(n, 0.0);
+    scratch_.assign(n, 0.0);
+    if (n < 3) return;
+
+    for (size_t i = 1; i + 1 < n; ++i) {
+        const double h0 = times[i] - times[i - 1];
+        const double h1 = times[i + 1] - times[i];
+        const double sig = h0 / (h0 + h1);
+        const double p = sig * second_derivatives_[i - 1] + 2.0;
+        second_derivatives_[i] = (sig - 1.0) / p;
+        const double slope = (values[i + 1] - values[i]) / h1 - (values[i] - values[i - 1]) / h0;
+        scratch_[i] = (6.0 * slope / (h0 + h1) - sig * scratch_[i - 1]) / p;
+    }
+
+    second_derivatives_[n - 1] = 0.0;
+    for (size_t i = n - 1; i-- > 0;) {
+        second_derivatives_[i] = second_derivatives_[i] * second_derivatives_[i + 1] + scratch_[i];
+    }
+}
+
+const std::vector<double> &RRResampler::Resample(const std::vector<double> &times,
+                                                 const std::vector<double> &values) {
+    output_.clear();
+    const size_t n = std::min(times.size(), values.size());
+    if (n == 0 || sampling_rate_ <= 0.0) return output_;
+    if (n == 1) {
+        output_.push_back(values[0]);
+        return output_;
+    }
+
+    const bool spline = mode_ == ResamplingMode::CubicSpline && n >= 3;
+    if (spline) PrepareSpline(times, values);
+
+    const double start = times.front();
+    const double dt = 1.0 / sampling_rate_;
+    const size_t samples = static_cast<size_t>(std::floor((times[n - 1] - start) * sampling_rate_)) + 1;
+    output_.resize(samples);
+
+    // Kursor po węzłach przesuwa się tylko do przodu razem z czasem próbki
+    size_t knot = 0;
+    for (size_t k = 0; k < samples; ++k) {
+        const double t = start + k * dt;
+        while (knot + 2 < n && times[knot + 1] <= t) ++knot;
+
+        const double h = times[knot + 1] - times[knot];
+        if (h <= 0.0) {
+            output_[k] = values[knot + 1];
+            continue;
+        }
+        const double b = std::min(1.0, std::max(0.0, (t - times[knot]) / h));
+        const double a = 1.0 - b;
+        double v = a * values[knot] + b * values[knot + 1];
+        if (spline) {
+            v += ((a * a * a - a) * second_derivatives_[knot] + (b * b * b - b) * second_derivatives_[knot + 1]) *
+                    (h * h) / 6.0;
+        }
+        output_[k] = v;
+    }
+
+    return output_;
+}
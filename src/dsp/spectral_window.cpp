@@ -0,0 +1,44 @@
+#include "../../include/dsp/spectral_window.h"
+#include <cmath>
+#include <utility>
+
+#include "../../include/util/lru_cache.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    // Liczba zapamiętanych okien (rozmiar i rodzaj) - jak dla planów FFT
+    constexpr size_t WINDOW_CACHE_SIZE = 16;
+}
+
+SpectralWindow::SpectralWindow(size_t size, WindowType type) : coefficients(size, 1.0) {
+    // Okna symetryczne (mianownik size - 1), jak dotychczasowe okno Hanna w periodogramie Welcha
+    const double denominator = size > 1 ? static_cast<double>(size - 1) : 1.0;
+    for (size_t i = 0; i < size; ++i) {
+        const double phase = 2.0 * M_PI * static_cast<double>(i) / denominator;
+        switch (type) {
+            case WindowType::Rectangular:
+                coefficients[i] = 1.0;
+                break;
+            case WindowType::Hann:
+                coefficients[i] = 0.5 * (1.0 - std::cos(phase));
+                break;
+            case WindowType::Hamming:
+                coefficients[i] = 0.54 - 0.46 * std::cos(phase);
+                break;
+            case WindowType::Blackman:
+                coefficients[i] = 0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+                break;
+        }
+        power += coefficients[i] * coefficients[i];
+    }
+}
+
+std::shared_ptr<const SpectralWindow> SpectralWindow::ForSize(size_t size, WindowType type) {
+    static LruCache<std::pair<size_t, WindowType>, SpectralWindow> cache(WINDOW_CACHE_SIZE);
+    return cache.Get(std::make_pair(size, type), [size, type]() {
+        return std::make_shared<const SpectralWindow>(size, type);
+    });
+}
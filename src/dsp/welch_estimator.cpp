@@ -0,0 +1,75 @@
+#include "../../include/dsp/welch_estimator.h"
+#include <algorithm>
+#include <complex>
+#include <numeric>
+
+#include "../../include/dsp/fft.h"
+#include "../../include/util/parallel_for.h"
+
+namespace {
+    // Liczba segmentów w jednej paczce; krótsze sygnały (np. okna 5-minutowe) liczone są w bieżącym wątku
+    constexpr size_t SEGMENTS_PER_BATCH = 32;
+}
+
+WelchEstimator::WelchEstimator(size_t segment_size, double overlap, WindowType window_type)
+    : segment_size_(segment_size), overlap_(overlap), window_type_(window_type) {
+}
+
+bool WelchEstimator::Estimate(
+    const std::vector<double> &signal,
+    double sampling_rate,
+    std::vector<double> &power,
+    std::vector<double> &frequencies) const {
+    const size_t n = signal.size();
+    if (segment_size_ < 2 || n < segment_size_) return false;
+
+    const size_t step = std::max<size_t>(1, static_cast<size_t>(segment_size_ * (1.0 - overlap_)));
+    const size_t num_segments = (n - segment_size_) / step + 1;
+
+    const auto window = SpectralWindow::ForSize(segment_size_, window_type_);
+    const size_t fft_size = RealFFT::NextFastSize(segment_size_);
+    const auto fft = RealFFT::ForSize(fft_size);
+    const size_t bins = fft->SpectrumSize();
+    const double mean = std::accumulate(signal.begin(), signal.end(), 0.0) / n;
+
+    const size_t batches = (num_segments + SEGMENTS_PER_BATCH - 1) / SEGMENTS_PER_BATCH;
+    std::vector<double> partial(batches * bins, 0.0);
+
+    ParallelForRange(batches, 1, [&](size_t from, size_t to) {
+        std::vector<double> windowed(fft_size, 0.0);
+        std::vector<std::complex<double>> spectrum(bins);
+        std::vector<std::complex<double>> workspace;
+        const double *coefficients = window->coefficients.data();
+
+        for (size_t batch = from; batch < to; ++batch) {
+            double *accumulator = partial.data() + batch * bins;
+            const size_t last = std::min(num_segments, (batch + 1) * SEGMENTS_PER_BATCH);
+            for (size_t seg = batch * SEGMENTS_PER_BATCH; seg < last; ++seg) {
+                // Usunięcie składowej stałej i okno w jednym przebiegu; końcówka bufora pozostaje wyzerowana
+                const double *x = signal.data() + seg * step;
+                for (size_t i = 0; i < segment_size_; ++i)
+                    windowed[i] = (x[i] - mean) * coefficients[i];
+                fft->Forward(windowed.data(), spectrum.data(), workspace);
+                for (size_t k = 0; k < bins; ++k)
+                    accumulator[k] += std::norm(spectrum[k]);
+            }
+        }
+    });
+
+    // Suma paczek w stałej kolejności, uśrednienie i normalizacja
+    power.assign(bins, 0.0);
+    for (size_t batch = 0; batch < batches; ++batch) {
+        const double *accumulator = partial.data() + batch * bins;
+        for (size_t k = 0; k < bins; ++k)
+            power[k] += accumulator[k];
+    }
+    // Segment uzupełniony zerami: suma |X|^2 rośnie z nfft, a df = fs / nfft maleje - normalizacja przez
+    // długość segmentu (nie nfft) utrzymuje moc w pasmach niezależną od uzupełnienia
+    const double normalization = window->power * num_segments * segment_size_;
+    frequencies.resize(bins);
+    for (size_t k = 0; k < bins; ++k) {
+        power[k] /= normalization;
+        frequencies[k] = k * sampling_rate / fft_size;
+    }
+    return true;
+}
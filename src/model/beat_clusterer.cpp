@@ -0,0 +1,90 @@
+#include "../../include/model/beat_clusterer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+BeatClusterer::BeatClusterer(size_t dimension, double min_correlation, size_t max_clusters)
+    : dimension_(dimension),
+      stride_((dimension + BLOCK - 1) / BLOCK * BLOCK),
+      max_distance_(static_cast<float>(2.0 - 2.0 * min_correlation)),
+      max_clusters_(std::max<size_t>(1, max_clusters)),
+      input_(stride_, 0.0f) {
+}
+
+float BeatClusterer::Distance(const float* morphology, const float* pattern, float bound) const {
+    float distance = 0.0f;
+    for (size_t block = 0; block < stride_; block += BLOCK) {
+        float partial[BLOCK];
+        for (size_t k = 0; k < BLOCK; ++k) {
+            const float d = morphology[block + k] - pattern[block + k];
+            partial[k] = d * d;
+        }
+        for (size_t k = 0; k < BLOCK; ++k) distance += partial[k];
+        if (distance > bound) break;
+    }
+    return distance;
+}
+
+void BeatClusterer::Assign(size_t cluster, const float* morphology) {
+    double* sum = &sums_[cluster * stride_];
+    float* pattern = &templates_[cluster * stride_];
+    for (size_t k = 0; k < stride_; ++k) sum[k] += morphology[k];
+
+    // Wzorzec to średnia członków sprowadzona z powrotem do normy 1
+    double norm = 0.0;
+    for (size_t k = 0; k < stride_; ++k) norm += sum[k] * sum[k];
+    const double scale = norm > 0.0 ? 1.0 / std::sqrt(norm) : 0.0;
+    for (size_t k = 0; k < stride_; ++k) pattern[k] = static_cast<float>(sum[k] * scale);
+
+    members_[cluster].push_back(count_);
+    last_cluster_ = cluster;
+}
+
+size_t BeatClusterer::Add(const float* morphology) {
+    // Końcówka input_ za dimension_ pozostaje wyzerowana
+    float* x = input_.data();
+    std::copy(morphology, morphology + dimension_, x);
+
+    const size_t clusters = members_.size();
+    const bool full = clusters >= max_clusters_;
+    // Po osiągnięciu limitu grup szukamy po prostu najbliższej
+    float best = full ? std::numeric_limits<float>::max() : max_distance_;
+    size_t best_cluster = clusters;
+
+    // Kolejne uderzenia zwykle należą do tej samej grupy, więc zaczynamy od ostatniej - jej wynik
+    // od razu zawęża ograniczenie dla pozostałych porównań
+    for (size_t i = 0; i < clusters; ++i) {
+        const size_t cluster = i == 0 ? last_cluster_ : (i <= last_cluster_ ? i - 1 : i);
+        const float distance = Distance(x, &templates_[cluster * stride_], best);
+        if (distance < best) {
+            best = distance;
+            best_cluster = cluster;
+        }
+    }
+
+    if (best_cluster == clusters) {
+        templates_.resize((clusters + 1) * stride_, 0.0f);
+        sums_.resize((clusters + 1) * stride_, 0.0);
+        members_.emplace_back();
+    }
+    Assign(best_cluster, x);
+    ++count_;
+    return best_cluster;
+}
+
+std::vector<BeatCluster> BeatClusterer::Clusters() const {
+    std::vector<size_t> order(members_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return members_[a].size() > members_[b].size();
+    });
+
+    std::vector<BeatCluster> clusters(order.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const float* pattern = &templates_[order[i] * stride_];
+        clusters[i].morphology.assign(pattern, pattern + dimension_);
+        clusters[i].members = members_[order[i]];
+    }
+    return clusters;
+}
@@ -0,0 +1,97 @@
+#include "../../include/model/compact_signal.h"
+#include <algorithm>
+#include <cmath>
+
+#include "../../include/util/half_float.h"
+
+namespace {
+    // Amplituda, na którą mapowane jest maksimum kanału przy kwantyzacji do Int16 (zapas na zaokrąglenie)
+    constexpr double INT16_FULL_SCALE = 32000.0;
+
+    // Liczba próbek odczytywanych naraz przy składaniu SignalDatapoint z kanałów
+    constexpr size_t READ_BLOCK = 1024;
+}
+
+CompactSignal::CompactSignal(SampleStorage storage, size_t size, size_t lead_count)
+    : storage_(storage == SampleStorage::Float16 ? SampleStorage::Float16 : SampleStorage::Int16),
+      size_(size),
+      lead_count_(lead_count),
+      samples_(size * lead_count, 0),
+      scale_(lead_count, 1.0f),
+      offset_(lead_count, 0.0f),
+      gain_(lead_count, 1.0),
+      baseline_(lead_count, 0.0) {
+}
+
+CompactSignal CompactSignal::FromDatapoints(const std::vector<SignalDatapoint>& datapoints, SampleStorage storage) {
+    const size_t leads = datapoints.empty() ? 0 : datapoints.front().channelValues.size();
+    CompactSignal signal(storage, datapoints.size(), leads);
+
+    if (signal.storage_ == SampleStorage::Int16) {
+        std::vector<float> peak(leads, 0.0f);
+        for (const auto& datapoint : datapoints)
+            for (size_t lead = 0; lead < leads; ++lead)
+                peak[lead] = std::max(peak[lead], std::fabs(datapoint.channelValues[lead]));
+        for (size_t lead = 0; lead < leads; ++lead)
+            signal.SetLeadScale(lead, peak[lead] > 0.0f ? INT16_FULL_SCALE / peak[lead] : 1.0, 0.0);
+    }
+
+    for (size_t k = 0; k < datapoints.size(); ++k)
+        for (size_t lead = 0; lead < leads; ++lead)
+            signal.Set(k, lead, datapoints[k].channelValues[lead]);
+    return signal;
+}
+
+void CompactSignal::SetLeadScale(size_t lead, double gain, double baseline) {
+    if (gain == 0.0) gain = 1.0;
+    gain_[lead] = gain;
+    baseline_[lead] = baseline;
+    scale_[lead] = static_cast<float>(1.0 / gain);
+    offset_[lead] = static_cast<float>(-baseline / gain);
+}
+
+void CompactSignal::Set(size_t sample, size_t lead, float value) {
+    uint16_t& slot = samples_[lead * size_ + sample];
+    if (storage_ == SampleStorage::Float16) {
+        slot = FloatToHalf(value);
+        return;
+    }
+    const double raw = std::round((static_cast<double>(value) - offset_[lead]) / scale_[lead]);
+    const double clamped = std::isfinite(raw) ? std::max(-32768.0, std::min(32767.0, raw)) : 0.0;
+    slot = static_cast<uint16_t>(static_cast<int16_t>(clamped));
+}
+
+float CompactSignal::At(size_t sample, size_t lead) const {
+    const uint16_t stored = samples_[lead * size_ + sample];
+    if (storage_ == SampleStorage::Float16) return HalfToFloat(stored);
+    return static_cast<float>(static_cast<int16_t>(stored)) * scale_[lead] + offset_[lead];
+}
+
+void CompactSignal::ReadLead(size_t lead, size_t from, size_t count, float* out) const {
+    const uint16_t* in = samples_.data() + lead * size_ + from;
+    if (storage_ == SampleStorage::Float16) {
+        HalfToFloat(in, out, count);
+        return;
+    }
+    const int16_t* raw = reinterpret_cast<const int16_t*>(in);
+    const float scale = scale_[lead];
+    const float offset = offset_[lead];
+    for (size_t i = 0; i < count; ++i) out[i] = static_cast<float>(raw[i]) * scale + offset;
+}
+
+std::vector<SignalDatapoint> CompactSignal::ToDatapoints(size_t from, size_t count) const {
+    count = from < size_ ? std::min(count, size_ - from) : 0;
+    std::vector<SignalDatapoint> datapoints(count);
+    for (auto& datapoint : datapoints) datapoint.channelValues.resize(lead_count_);
+
+    // Kanały są odczytywane blokami do ciągłego bufora, a dopiero potem rozkładane na próbki
+    std::vector<float> block(READ_BLOCK);
+    for (size_t start = 0; start < count; start += READ_BLOCK) {
+        const size_t length = std::min(READ_BLOCK, count - start);
+        for (size_t lead = 0; lead < lead_count_; ++lead) {
+            ReadLead(lead, from + start, length, block.data());
+            for (size_t i = 0; i < length; ++i) datapoints[start + i].channelValues[lead] = block[i];
+        }
+    }
+    return datapoints;
+}
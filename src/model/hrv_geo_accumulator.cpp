@@ -0,0 +1,85 @@
+#include "../../include/model/hrv_geo_accumulator.h"
+#include <algorithm>
+#include <cmath>
+
+HRVGeoAccumulator::HRVGeoAccumulator() : histogram_(BIN_COUNT, 0) {
+}
+
+void HRVGeoAccumulator::AddInterval(double interval_ms) {
+    const double position = std::max(0.0, interval_ms / BIN_WIDTH_MS);
+    const size_t bin = std::min(BIN_COUNT - 1, static_cast<size_t>(position));
+    ++histogram_[bin];
+    ++interval_count_;
+}
+
+void HRVGeoAccumulator::AddPair(double previous_ms, double current_ms) {
+    const double x = (current_ms + previous_ms) / std::sqrt(2.0);
+    const double y = (current_ms - previous_ms) / std::sqrt(2.0);
+
+    ++pair_count_;
+    const double dx = x - mean_x_;
+    const double dy = y - mean_y_;
+    mean_x_ += dx / pair_count_;
+    mean_y_ += dy / pair_count_;
+    m2_x_ += dx * (x - mean_x_);
+    m2_y_ += dy * (y - mean_y_);
+}
+
+void HRVGeoAccumulator::Add(double interval_ms, bool successive) {
+    AddInterval(interval_ms);
+    if (successive && has_last_) AddPair(last_interval_, interval_ms);
+    last_interval_ = interval_ms;
+    has_last_ = true;
+}
+
+void HRVGeoAccumulator::Merge(const HRVGeoAccumulator &other) {
+    for (size_t i = 0; i < BIN_COUNT; ++i) histogram_[i] += other.histogram_[i];
+    interval_count_ += other.interval_count_;
+
+    if (other.pair_count_ > 0) {
+        const double n_a = static_cast<double>(pair_count_);
+        const double n_b = static_cast<double>(other.pair_count_);
+        const double n = n_a + n_b;
+        const double dx = other.mean_x_ - mean_x_;
+        const double dy = other.mean_y_ - mean_y_;
+        mean_x_ += dx * n_b / n;
+        mean_y_ += dy * n_b / n;
+        m2_x_ += other.m2_x_ + dx * dx * n_a * n_b / n;
+        m2_y_ += other.m2_y_ + dy * dy * n_a * n_b / n;
+        pair_count_ += other.pair_count_;
+    }
+
+    // Dalsze Add() kontynuują serię dołączonego akumulatora
+    if (other.has_last_) {
+        last_interval_ = other.last_interval_;
+        has_last_ = true;
+    }
+}
+
+HRVGeoMetrics HRVGeoAccumulator::Metrics() const {
+    HRVGeoMetrics metrics;
+    if (interval_count_ < 2) return metrics;
+
+    // HISTOGRAM RR - przycięty do zakresu niepustych przedziałów
+    size_t first = 0, last = BIN_COUNT - 1;
+    while (histogram_[first] == 0) ++first;
+    while (histogram_[last] == 0) --last;
+    metrics.histogram.assign(histogram_.begin() + first, histogram_.begin() + last + 1);
+    metrics.histogram_start = first * BIN_WIDTH_MS;
+    metrics.histogram_bin_width = BIN_WIDTH_MS;
+
+    // TRIANGULAR INDEX i TiNN
+    const double max_bin_height = *std::max_element(metrics.histogram.begin(), metrics.histogram.end());
+    if (max_bin_height > 0.0) {
+        metrics.triangular_index = static_cast<double>(interval_count_) / max_bin_height;
+        metrics.tinn = static_cast<double>(interval_count_) / (max_bin_height * BIN_WIDTH_MS);
+    }
+
+    // ANALIZA POINCARE (SD1, SD2)
+    if (pair_count_ > 1) {
+        metrics.sd2 = std::sqrt(m2_x_ / (static_cast<double>(pair_count_) - 1.0));
+        metrics.sd1 = std::sqrt(m2_y_ / (static_cast<double>(pair_count_) - 1.0));
+    }
+
+    return metrics;
+}
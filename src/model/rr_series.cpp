@@ -0,0 +1,51 @@
+#include "../../include/model/rr_series.h"
+
+RRSeries RRSeries::FromPeaks(
+    const std::vector<RPeaksAnnotatedSignalDatapoint> &r_peaks,
+    int frequency,
+    const SignalQuality *quality,
+    double min_interval_ms,
+    double max_interval_ms) {
+    RRSeries series;
+    series.frequency = frequency;
+    if (frequency <= 0) return series;
+
+    for (size_t i = 0; i < r_peaks.size(); ++i) {
+        if (r_peaks[i].peak) series.peaks.push_back(static_cast<int64_t>(i));
+    }
+    if (series.peaks.size() < 2) return series;
+
+    const size_t count = series.peaks.size() - 1;
+    series.times.reserve(count);
+    series.intervals.reserve(count);
+    series.flags.reserve(count);
+    series.nn_times.reserve(count);
+    series.nn_intervals.reserve(count);
+    series.nn_successive.reserve(count);
+
+    bool previous_nn = false;
+    for (size_t i = 1; i < series.peaks.size(); ++i) {
+        const int64_t from = series.peaks[i - 1];
+        const int64_t to = series.peaks[i];
+        const double interval_ms = static_cast<double>(to - from) * 1000.0 / frequency;
+        const double time = static_cast<double>(to) / frequency;
+
+        uint8_t flags = None;
+        if (interval_ms <= min_interval_ms || interval_ms >= max_interval_ms) flags |= OutOfRange;
+        if (quality && (!quality->IsUsable(from) || !quality->IsUsable(to)))
+            flags |= LowQuality;
+
+        series.times.push_back(time);
+        series.intervals.push_back(interval_ms);
+        series.flags.push_back(flags);
+
+        if (flags == None) {
+            series.nn_times.push_back(time);
+            series.nn_intervals.push_back(interval_ms);
+            series.nn_successive.push_back(previous_nn);
+        }
+        previous_nn = flags == None;
+    }
+
+    return series;
+}
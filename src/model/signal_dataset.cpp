@@ -0,0 +1,115 @@
+#include "../../include/model/signal_dataset.h"
+#include <algorithm>
+
+namespace {
+    // Indeks odprowadzenia w trybie derived_limb_leads: I, II, a dalej V1..V6 przesunięte o 4 wyliczane
+    constexpr int STORAGE_INDEX[SignalDataset::STANDARD_LEAD_COUNT] = {0, 1, -1, -1, -1, -1, 2, 3, 4, 5, 6, 7};
+}
+
+SignalDataset::SignalDataset(const SignalDataset& other)
+    : values(other.values), frequency(other.frequency), start_time_us(other.start_time_us),
+      derived_limb_leads(other.derived_limb_leads), compact(other.compact) {
+    std::copy(&other.derived_lead_weights[0][0], &other.derived_lead_weights[0][0] + 12, &derived_lead_weights[0][0]);
+}
+
+SignalDataset& SignalDataset::operator=(const SignalDataset& other) {
+    if (this != &other) {
+        values = other.values;
+        frequency = other.frequency;
+        start_time_us = other.start_time_us;
+        derived_limb_leads = other.derived_limb_leads;
+        compact = other.compact;
+        std::copy(&other.derived_lead_weights[0][0], &other.derived_lead_weights[0][0] + 12,
+                  &derived_lead_weights[0][0]);
+        InvalidateDerivedLeads();
+    }
+    return *this;
+}
+
+size_t SignalDataset::ChannelCount() const {
+    if (compact) return compact->LeadCount();
+    return values.empty() ? 0 : values.front().channelValues.size();
+}
+
+void SignalDataset::ReadChannel(size_t channel, size_t from, size_t count, float* out) const {
+    if (compact) {
+        compact->ReadLead(channel, from, count, out);
+        return;
+    }
+    for (size_t k = 0; k < count; ++k) out[k] = values[from + k].channelValues[channel];
+}
+
+std::vector<SignalDatapoint> SignalDataset::Samples(size_t from, size_t count) const {
+    if (compact) return compact->ToDatapoints(from, count);
+    from = std::min(from, values.size());
+    count = std::min(count, values.size() - from);
+    return std::vector<SignalDatapoint>(values.begin() + from, values.begin() + from + count);
+}
+
+size_t SignalDataset::LeadCount() const {
+    if (derived_limb_leads) return STANDARD_LEAD_COUNT;
+    return ChannelCount();
+}
+
+int SignalDataset::StorageIndex(size_t lead, bool derived_limb_leads) {
+    if (!derived_limb_leads) return static_cast<int>(lead);
+    return lead < STANDARD_LEAD_COUNT ? STORAGE_INDEX[lead] : -1;
+}
+
+float SignalDataset::Value(size_t sample, size_t lead) const {
+    const int index = StorageIndex(lead);
+    if (index >= 0) return compact ? compact->At(sample, index) : values[sample].channelValues[index];
+    const float* weights = derived_lead_weights[lead - III];
+    return weights[0] * Value(sample, I) + weights[1] * Value(sample, II) + weights[2];
+}
+
+std::shared_ptr<const std::vector<float>> SignalDataset::DerivedLead(size_t lead) const {
+    if (!derived_limb_leads || lead < III || lead > AVF) return nullptr;
+
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    if (!derived_[0]) {
+        const size_t n = Size();
+        std::vector<float> i_lead(n), ii_lead(n);
+        ReadChannel(I, 0, n, i_lead.data());
+        ReadChannel(II, 0, n, ii_lead.data());
+
+        // Z ciągłych buforów I i II - pętla bez zależności między próbkami, wektoryzowana przez kompilator
+        for (size_t d = 0; d < 4; ++d) {
+            const float w_i = derived_lead_weights[d][0];
+            const float w_ii = derived_lead_weights[d][1];
+            const float offset = derived_lead_weights[d][2];
+            std::vector<float> derived(n);
+            for (size_t k = 0; k < n; ++k) derived[k] = w_i * i_lead[k] + w_ii * ii_lead[k] + offset;
+            derived_[d] = std::make_shared<const std::vector<float>>(std::move(derived));
+        }
+    }
+    return derived_[lead - III];
+}
+
+void SignalDataset::InvalidateDerivedLeads() {
+    std::lock_guard<std::mutex> lock(derived_mutex_);
+    for (auto& lead : derived_) lead.reset();
+}
+
+std::vector<SignalDatapoint> SignalDataset::Expanded() const {
+    if (!derived_limb_leads) return Samples(0, Size());
+
+    std::vector<SignalDatapoint> stored;
+    if (compact) stored = compact->ToDatapoints(0, compact->Size());
+    const std::vector<SignalDatapoint>& source = compact ? stored : values;
+
+    std::vector<SignalDatapoint> expanded(source.size());
+    for (size_t k = 0; k < source.size(); ++k) {
+        const float* v = source[k].channelValues.data();
+        const float a = v[0];
+        const float b = v[1];
+        auto derived = [&](size_t d) {
+            return derived_lead_weights[d][0] * a + derived_lead_weights[d][1] * b + derived_lead_weights[d][2];
+        };
+        expanded[k].channelValues = {
+            a, b, derived(0), derived(1), derived(2), derived(3),
+            v[2], v[3], v[4], v[5], v[6], v[7]
+        };
+    }
+    return expanded;
+}
@@ -0,0 +1,392 @@
+#include "../../include/repository/compressed_signal_repository.h"
+
+#include <QtCore/QFile>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "../../include/model/signal_dataset.h"
+#include "../../include/util/bit_stream.h"
+#include "../../include/util/parallel_for.h"
+#include "../../include/util/sample_time.h"
+
+namespace {
+    constexpr char MAGIC[4] = {'E', 'K', 'G', 'Z'};
+    // Wersja 2 dodaje początek zapisu (i64 mikrosekundy od 1970-01-01) po bajtach zarezerwowanych
+    constexpr uint16_t VERSION = 2;
+    constexpr uint8_t FLAG_DERIVED_LIMB_LEADS = 1;
+    constexpr qint64 FIXED_HEADER_SIZE = 28;
+
+    constexpr int MAX_ORDER = 3;
+    constexpr int MAX_RICE_PARAMETER = 24;
+    // Liczba jedynek, po której zamiast kodu Rice'a następuje surowa 32-bitowa wartość
+    constexpr int ESCAPE_LENGTH = 24;
+
+    // ---------- zapis i odczyt liczb little endian ----------
+    template<typename T>
+    void Put(std::vector<uint8_t>& out, T value) {
+        uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        uint64_t bits = 0;
+        std::memcpy(&bits, bytes, sizeof(T));
+        for (size_t i = 0; i < sizeof(T); ++i) out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+    }
+
+    template<typename T>
+    bool Get(const uint8_t*& data, const uint8_t* end, T& value) {
+        if (end - data < static_cast<ptrdiff_t>(sizeof(T))) return false;
+        uint64_t bits = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) bits |= static_cast<uint64_t>(data[i]) << (8 * i);
+        std::memcpy(&value, &bits, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    uint32_t ZigZag(int32_t value) {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    int32_t UnZigZag(uint32_t value) {
+        return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+    }
+
+    // Reszta stałego predyktora rzędu order dla próbki i (i >= order)
+    int32_t Residual(const int32_t* x, size_t i, int order) {
+        switch (order) {
+            case 0: return x[i];
+            case 1: return x[i] - x[i - 1];
+            case 2: return x[i] - 2 * x[i - 1] + x[i - 2];
+            default: return x[i] - 3 * x[i - 1] + 3 * x[i - 2] - x[i - 3];
+        }
+    }
+
+    int32_t Predict(const int32_t* x, size_t i, int order) {
+        switch (order) {
+            case 0: return 0;
+            case 1: return x[i - 1];
+            case 2: return 2 * x[i - 1] - x[i - 2];
+            default: return 3 * x[i - 1] - 3 * x[i - 2] + x[i - 3];
+        }
+    }
+
+    // Liczba bitów kodu Rice'a dla reszt u z parametrem k
+    uint64_t RiceCost(const std::vector<uint32_t>& u, int k) {
+        uint64_t bits = 0;
+        for (uint32_t value : u) {
+            const uint32_t q = value >> k;
+            bits += q < ESCAPE_LENGTH ? q + 1 + k : ESCAPE_LENGTH + 32;
+        }
+        return bits;
+    }
+
+    // Koduje jeden kanał jednego bloku
+    void EncodeLead(const int32_t* x, size_t length, BitWriter& writer, std::vector<uint32_t>& u) {
+        const int max_order = static_cast<int>(std::min<size_t>(MAX_ORDER, length));
+
+        // Rząd predyktora o najmniejszej sumie reszt
+        int order = 0;
+        uint64_t best_sum = std::numeric_limits<uint64_t>::max();
+        for (int candidate = 0; candidate <= max_order; ++candidate) {
+            uint64_t sum = 0;
+            for (size_t i = MAX_ORDER; i < length; ++i) sum += ZigZag(Residual(x, i, candidate));
+            if (sum < best_sum) {
+                best_sum = sum;
+                order = candidate;
+            }
+        }
+
+        u.clear();
+        for (size_t i = order; i < length; ++i) u.push_back(ZigZag(Residual(x, i, order)));
+
+        // Parametr Rice'a: oszacowanie z średniej reszty, poprawione o sąsiednie wartości
+        int k = 0;
+        if (!u.empty()) {
+            uint64_t sum = 0;
+            for (uint32_t value : u) sum += value;
+            const double mean = static_cast<double>(sum) / static_cast<double>(u.size());
+            k = mean > 1.0 ? static_cast<int>(std::log2(mean)) : 0;
+            k = std::max(0, std::min(MAX_RICE_PARAMETER, k));
+            uint64_t best_cost = RiceCost(u, k);
+            for (int candidate : {k - 1, k + 1}) {
+                if (candidate < 0 || candidate > MAX_RICE_PARAMETER) continue;
+                const uint64_t cost = RiceCost(u, candidate);
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    k = candidate;
+                }
+            }
+        }
+
+        writer.Write(static_cast<uint32_t>(order), 2);
+        writer.Write(static_cast<uint32_t>(k), 5);
+        for (int i = 0; i < order; ++i) writer.Write(static_cast<uint16_t>(x[i]), 16);
+        for (uint32_t value : u) {
+            const uint32_t q = value >> k;
+            if (q < ESCAPE_LENGTH) {
+                writer.WriteOnes(static_cast<int>(q));
+                writer.Write(0, 1);
+                writer.Write(value, k);
+            } else {
+                writer.WriteOnes(ESCAPE_LENGTH);
+                writer.Write(value, 32);
+            }
+        }
+    }
+
+    // Dekoduje blok; store(próbka w bloku, kanał, wartość) dla każdej próbki
+    template<typename Store>
+    void DecodeBlock(const uint8_t* data, size_t size, size_t length, size_t leads, Store&& store) {
+        BitReader reader(data, size);
+        std::vector<int32_t> x(length);
+        for (size_t lead = 0; lead < leads; ++lead) {
+            const int order = static_cast<int>(reader.Read(2));
+            const int k = static_cast<int>(reader.Read(5));
+            const size_t warmup = std::min<size_t>(order, length);
+            for (size_t i = 0; i < warmup; ++i) x[i] = static_cast<int16_t>(reader.Read(16));
+            for (size_t i = warmup; i < length; ++i) {
+                const int q = reader.ReadOnes(ESCAPE_LENGTH);
+                const uint32_t u = q < ESCAPE_LENGTH ? (static_cast<uint32_t>(q) << k) | reader.Read(k) : reader.Read(32);
+                x[i] = Predict(x.data(), i, order) + UnZigZag(u);
+            }
+            for (size_t i = 0; i < length; ++i) store(i, lead, static_cast<int16_t>(x[i]));
+        }
+    }
+
+    struct FileHeader {
+        uint16_t leads = 0;
+        int32_t frequency = 0;
+        uint64_t samples = 0;
+        uint32_t block_size = 0;
+        uint8_t flags = 0;
+        int64_t start_time_us = SignalDataset::NO_START_TIME;
+        std::vector<double> gains;
+        std::vector<double> baselines;
+        float derived_lead_weights[4][3] = {};
+        std::vector<uint64_t> offsets; // liczba bloków + 1
+        uint64_t data_start = 0;       // przesunięcie danych bloków w pliku
+    };
+
+    bool ReadHeader(QFile& file, FileHeader& header) {
+        const QByteArray fixed = file.read(FIXED_HEADER_SIZE);
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(fixed.constData());
+        const uint8_t* end = data + fixed.size();
+        if (fixed.size() != FIXED_HEADER_SIZE || std::memcmp(data, MAGIC, 4) != 0) return false;
+        data += 4;
+        uint16_t version = 0;
+        uint8_t reserved = 0;
+        if (!Get(data, end, version) || version < 1 || version > VERSION) return false;
+        Get(data, end, header.leads);
+        Get(data, end, header.frequency);
+        Get(data, end, header.samples);
+        Get(data, end, header.block_size);
+        Get(data, end, header.flags);
+        for (int i = 0; i < 3; ++i) Get(data, end, reserved);
+        if (header.leads == 0 || header.block_size == 0 || header.frequency <= 0) return false;
+        if (version >= 2) {
+            const QByteArray start = file.read(8);
+            data = reinterpret_cast<const uint8_t*>(start.constData());
+            if (!Get(data, data + start.size(), header.start_time_us)) return false;
+        }
+
+        const bool derived = header.flags & FLAG_DERIVED_LIMB_LEADS;
+        const qint64 variable_size = header.leads * 16 + (derived ? 48 : 0) + 8;
+        const QByteArray scales = file.read(variable_size);
+        if (scales.size() != variable_size) return false;
+        data = reinterpret_cast<const uint8_t*>(scales.constData());
+        end = data + scales.size();
+        header.gains.resize(header.leads);
+        header.baselines.resize(header.leads);
+        for (size_t lead = 0; lead < header.leads; ++lead) {
+            Get(data, end, header.gains[lead]);
+            Get(data, end, header.baselines[lead]);
+        }
+        if (derived)
+            for (auto& weights : header.derived_lead_weights)
+                for (float& weight : weights) Get(data, end, weight);
+        uint64_t blocks = 0;
+        Get(data, end, blocks);
+        if (blocks != (header.samples + header.block_size - 1) / header.block_size) return false;
+
+        // Tablica przesunięć musi mieścić się w pliku, zanim zostanie wczytana
+        const uint64_t remaining = static_cast<uint64_t>(std::max<qint64>(0, file.size() - file.pos()));
+        if (blocks >= remaining / 8) return false;
+        const qint64 table_size = static_cast<qint64>((blocks + 1) * 8);
+        const QByteArray table = file.read(table_size);
+        if (table.size() != table_size) return false;
+        data = reinterpret_cast<const uint8_t*>(table.constData());
+        end = data + table.size();
+        header.offsets.resize(blocks + 1);
+        for (uint64_t& offset : header.offsets) Get(data, end, offset);
+        header.data_start = static_cast<uint64_t>(file.pos());
+
+        // Przesunięcia niemalejące i w granicach danych bloków - inaczej długość bloku byłaby ujemna
+        // albo blok wychodziłby poza wczytany bufor
+        const uint64_t data_size = remaining - static_cast<uint64_t>(table_size);
+        if (header.offsets.front() != 0 || header.offsets.back() > data_size) return false;
+        for (size_t block = 0; block < blocks; ++block)
+            if (header.offsets[block + 1] < header.offsets[block]) return false;
+
+        // Każda próbka kanału zajmuje w bloku co najmniej jeden bit (nagłówek i rozbieg predyktora więcej),
+        // więc zapis deklarujący więcej próbek, niż mieszczą dane, jest uszkodzony - sprawdzane przed
+        // alokacją CompactSignal o rozmiarze z nagłówka
+        if (header.samples > std::numeric_limits<uint64_t>::max() / 8 / header.leads ||
+            header.samples * header.leads > data_size * 8)
+            return false;
+        return true;
+    }
+}
+
+CompressedSignalRepository::CompressedSignalRepository(int block_size) : block_size_(std::max(16, block_size)) {
+}
+
+std::shared_ptr<SignalDataset> CompressedSignalRepository::Load(const QString& source) {
+    return LoadRange(source, 0, std::numeric_limits<int64_t>::max());
+}
+
+std::shared_ptr<SignalDataset> CompressedSignalRepository::LoadRange(const QString& source, int64_t from,
+                                                                     int64_t count) {
+    QFile file(source);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::cerr << "Error: Cannot open compressed record: " << source.toStdString() << std::endl;
+        return std::make_shared<SignalDataset>();
+    }
+
+    FileHeader header;
+    if (!ReadHeader(file, header)) {
+        std::cerr << "Error: Invalid compressed record header: " << source.toStdString() << std::endl;
+        return std::make_shared<SignalDataset>();
+    }
+
+    const uint64_t total = header.samples;
+    const uint64_t first = static_cast<uint64_t>(std::max<int64_t>(0, from));
+    const uint64_t last = count > 0 && first < total
+                              ? std::min<uint64_t>(total, first + std::min<uint64_t>(count, total - first))
+                              : first;
+
+    auto dataset = std::make_shared<SignalDataset>();
+    dataset->frequency = header.frequency;
+    // Znacznik początku fragmentu, a nie całego zapisu - indeks 0 zbioru to próbka first
+    if (header.start_time_us != SignalDataset::NO_START_TIME)
+        dataset->start_time_us = header.start_time_us +
+                                 SampleToMicroseconds(static_cast<int64_t>(first), header.frequency);
+    dataset->derived_limb_leads = header.flags & FLAG_DERIVED_LIMB_LEADS;
+    std::memcpy(dataset->derived_lead_weights, header.derived_lead_weights, sizeof(header.derived_lead_weights));
+
+    const size_t leads = header.leads;
+    const size_t size = static_cast<size_t>(last > first ? last - first : 0);
+    auto compact = std::make_shared<CompactSignal>(SampleStorage::Int16, size, leads);
+    for (size_t lead = 0; lead < leads; ++lead)
+        compact->SetLeadScale(lead, header.gains[lead], header.baselines[lead]);
+    dataset->compact = compact;
+    if (size == 0) return dataset;
+
+    // Tylko bloki obejmujące zakres - jeden ciągły odczyt
+    const uint64_t block_size = header.block_size;
+    const size_t first_block = static_cast<size_t>(first / block_size);
+    const size_t last_block = static_cast<size_t>((last - 1) / block_size);
+    const uint64_t begin = header.offsets[first_block];
+    const uint64_t end = header.offsets[last_block + 1];
+    if (end < begin || !file.seek(static_cast<qint64>(header.data_start + begin))) {
+        std::cerr << "Error: Corrupted block table: " << source.toStdString() << std::endl;
+        return std::make_shared<SignalDataset>();
+    }
+    const QByteArray bytes = file.read(static_cast<qint64>(end - begin));
+    if (static_cast<uint64_t>(bytes.size()) != end - begin) {
+        std::cerr << "Error: Compressed record is truncated: " << source.toStdString() << std::endl;
+        return std::make_shared<SignalDataset>();
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(bytes.constData());
+
+    ParallelFor(last_block - first_block + 1, [&](size_t i) {
+        const size_t block = first_block + i;
+        const uint64_t block_start = block * block_size;
+        const size_t length = static_cast<size_t>(std::min<uint64_t>(block_size, total - block_start));
+        const uint64_t offset = header.offsets[block] - begin;
+        const size_t block_bytes = static_cast<size_t>(header.offsets[block + 1] - header.offsets[block]);
+        DecodeBlock(data + offset, block_bytes, length, leads, [&](size_t k, size_t lead, int16_t raw) {
+            const uint64_t sample = block_start + k;
+            if (sample >= first && sample < last) compact->SetRaw(static_cast<size_t>(sample - first), lead, raw);
+        });
+    });
+
+    std::cout << "Loaded " << size << " samples x " << leads << " channels at "
+            << dataset->frequency << " Hz from " << source.toStdString() << std::endl;
+    return dataset;
+}
+
+bool CompressedSignalRepository::Save(const SignalDataset& dataset, const QString& destination) const {
+    // Źródło surowych wartości int16 ze skalą kanałów
+    std::shared_ptr<const CompactSignal> source = dataset.compact;
+    if (!source || source->Storage() != SampleStorage::Int16) {
+        source = std::make_shared<const CompactSignal>(
+            CompactSignal::FromDatapoints(dataset.Samples(0, dataset.Size()), SampleStorage::Int16));
+    }
+    const size_t leads = source->LeadCount();
+    const size_t samples = source->Size();
+    if (leads == 0 || leads > 0xffff) return false;
+
+    const size_t block_size = static_cast<size_t>(block_size_);
+    const size_t blocks = (samples + block_size - 1) / block_size;
+
+    // Bloki kodowane równolegle, każdy do własnego bufora
+    std::vector<std::vector<uint8_t>> encoded(blocks);
+    ParallelFor(blocks, [&](size_t block) {
+        const size_t start = block * block_size;
+        const size_t length = std::min(block_size, samples - start);
+        std::vector<int32_t> x(length);
+        std::vector<uint32_t> residuals;
+        residuals.reserve(length);
+        BitWriter writer(encoded[block]);
+        for (size_t lead = 0; lead < leads; ++lead) {
+            for (size_t i = 0; i < length; ++i) x[i] = source->Raw(start + i, lead);
+            EncodeLead(x.data(), length, writer, residuals);
+        }
+        writer.Flush();
+    });
+
+    std::vector<uint8_t> header;
+    header.insert(header.end(), MAGIC, MAGIC + 4);
+    Put(header, VERSION);
+    Put(header, static_cast<uint16_t>(leads));
+    Put(header, static_cast<int32_t>(dataset.frequency));
+    Put(header, static_cast<uint64_t>(samples));
+    Put(header, static_cast<uint32_t>(block_size));
+    Put(header, static_cast<uint8_t>(dataset.derived_limb_leads ? FLAG_DERIVED_LIMB_LEADS : 0));
+    for (int i = 0; i < 3; ++i) Put(header, static_cast<uint8_t>(0));
+    Put(header, dataset.start_time_us);
+    for (size_t lead = 0; lead < leads; ++lead) {
+        Put(header, source->Gain(lead));
+        Put(header, source->Baseline(lead));
+    }
+    if (dataset.derived_limb_leads)
+        for (const auto& weights : dataset.derived_lead_weights)
+            for (float weight : weights) Put(header, weight);
+    Put(header, static_cast<uint64_t>(blocks));
+    uint64_t offset = 0;
+    Put(header, offset);
+    for (const auto& block : encoded) {
+        offset += block.size();
+        Put(header, offset);
+    }
+
+    QFile file(destination);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "Error: Cannot create compressed record: " << destination.toStdString() << std::endl;
+        return false;
+    }
+    bool ok = file.write(reinterpret_cast<const char*>(header.data()), static_cast<qint64>(header.size())) ==
+              static_cast<qint64>(header.size());
+    for (const auto& block : encoded) {
+        if (!ok) break;
+        ok = file.write(reinterpret_cast<const char*>(block.data()), static_cast<qint64>(block.size())) ==
+             static_cast<qint64>(block.size());
+    }
+    file.close();
+    if (!ok) std::cerr << "Error: Cannot write compressed record: " << destination.toStdString() << std::endl;
+    return ok;
+}
@@ -88,8 +88,8 @@ static bool parse_gain_baseline(const QString &line,
 }
 
 
-static std::vector<float> resample_linear(const std::vector<float> &src, int targetLen) {
-    const int srcLen = static_cast<int>(src.size());
+static std::vector<float> resample_linear(const std::vector<float> &src, int64_t targetLen) {
+    const int64_t srcLen = static_cast<int64_t>(src.size());
     std::vector<float> out(targetLen, 0.0f);
 
     if (targetLen <= 0) return out;
@@ -106,10 +106,10 @@ static std::vector<float> resample_linear(const std::vector<float> &src, int tar
     const double scale =
             static_cast<double>(srcLen - 1) / static_cast<double>(targetLen - 1);
 
-    for (int i = 0; i < targetLen; ++i) {
+    for (int64_t i = 0; i < targetLen; ++i) {
         double pos = i * scale;
-        int left = static_cast<int>(std::floor(pos));
-        int right = std::min(left + 1, srcLen - 1);
+        int64_t left = static_cast<int64_t>(std::floor(pos));
+        int64_t right = std::min(left + 1, srcLen - 1);
         double t = pos - left;
         out[i] = static_cast<float>((1.0 - t) * src[left] + t * src[right]);
     }
@@ -118,13 +118,13 @@ static std::vector<float> resample_linear(const std::vector<float> &src, int tar
 }
 
 static void interpolate_invalid_inplace(std::vector<float> &v) {
-    const int n = static_cast<int>(v.size());
+    const int64_t n = static_cast<int64_t>(v.size());
     if (n == 0) return;
 
     auto isBad = [](float x) { return !std::isfinite(x); };
 
-    int firstValid = -1;
-    for (int i = 0; i < n; ++i) {
+    int64_t firstValid = -1;
+    for (int64_t i = 0; i < n; ++i) {
         if (!isBad(v[i])) {
             firstValid = i;
             break;
@@ -136,12 +136,12 @@ static void interpolate_invalid_inplace(std::vector<float> &v) {
     }
 
 
-    for (int i = 0; i < firstValid; ++i) {
+    for (int64_t i = 0; i < firstValid; ++i) {
         v[i] = v[firstValid];
     }
 
-    int lastValid = firstValid;
-    int i = firstValid + 1;
+    int64_t lastValid = firstValid;
+    int64_t i = firstValid + 1;
 
     while (i < n) {
         if (!isBad(v[i])) {
@@ -150,14 +150,14 @@ static void interpolate_invalid_inplace(std::vector<float> &v) {
             continue;
         }
 
-        int startBad = i;
-        int endBad = i;
+        int64_t startBad = i;
+        int64_t endBad = i;
         while (endBad < n && isBad(v[endBad])) {
             ++endBad;
         }
 
         if (endBad == n) {
-            for (int k = startBad; k < n; ++k) {
+            for (int64_t k = startBad; k < n; ++k) {
                 v[k] = v[lastValid];
             }
             break;
@@ -165,9 +165,9 @@ static void interpolate_invalid_inplace(std::vector<float> &v) {
 
         float leftVal = v[lastValid];
         float rightVal = v[endBad];
-        int gap = endBad - lastValid;
+        int64_t gap = endBad - lastValid;
 
-        for (int k = 1; k < gap; ++k) {
+        for (int64_t k = 1; k < gap; ++k) {
             float t = static_cast<float>(k) / static_cast<float>(gap);
             v[lastValid + k] = (1.0f - t) * leftVal + t * rightVal;
         }
@@ -178,6 +178,44 @@ static void interpolate_invalid_inplace(std::vector<float> &v) {
 }
 
 
+// Czy nazwy kanałów to standardowe 12 odprowadzeń w kolejności I, II, III, aVR, aVL, aVF, V1..V6
+static bool is_standard_12_lead(const std::vector<QString> &leadNames) {
+    static const char *standard[] = {"i", "ii", "iii", "avr", "avl", "avf", "v1", "v2", "v3", "v4", "v5", "v6"};
+    if (leadNames.size() != 12) return false;
+    for (int ch = 0; ch < 12; ++ch) {
+        if (leadNames[ch].compare(QString(standard[ch]), Qt::CaseInsensitive) != 0) return false;
+    }
+    return true;
+}
+
+// Początek zapisu z linii rekordu WFDB: czas "HH:MM:SS[.sss]" i data "DD/MM/YYYY".
+// Zwraca mikrosekundy od 1970-01-01 albo SignalDataset::NO_START_TIME, jeśli pola są niepoprawne.
+static int64_t parse_base_time(const QString &time, const QString &date) {
+    const QStringList hms = time.split(':', Qt::SkipEmptyParts);
+    const QStringList dmy = date.split('/', Qt::SkipEmptyParts);
+    if (hms.size() != 3 || dmy.size() != 3) return SignalDataset::NO_START_TIME;
+
+    bool okH = false, okM = false, okS = false, okD = false, okMo = false, okY = false;
+    const int hours = hms[0].toInt(&okH);
+    const int minutes = hms[1].toInt(&okM);
+    const double seconds = hms[2].toDouble(&okS);
+    const int day = dmy[0].toInt(&okD);
+    const int month = dmy[1].toInt(&okMo);
+    const int year = dmy[2].toInt(&okY);
+    if (!okH || !okM || !okS || !okD || !okMo || !okY || month < 1 || month > 12 || day < 1 || day > 31 ||
+        hours < 0 || hours > 23 || minutes < 0 || minutes > 59 || seconds < 0.0 || seconds >= 61.0) {
+        return SignalDataset::NO_START_TIME;
+    }
+
+    const int64_t whole_seconds = DaysFromCivil(year, month, day) * 86400 + hours * 3600 + minutes * 60;
+    return whole_seconds * MICROSECONDS_PER_SECOND + std::llround(seconds * MICROSECONDS_PER_SECOND);
+}
+
+
+DATSignalRepository::DATSignalRepository(bool independent_leads_only, SampleStorage storage)
+    : independent_leads_only_(independent_leads_only), storage_(storage) {
+}
+
 std::shared_ptr<SignalDataset> DATSignalRepository::Load(const QString &filename) {
     QFileInfo fileInfo(filename);
     const QString baseName = fileInfo.completeBaseName();
@@ -208,7 +246,7 @@ std::shared_ptr<SignalDataset> DATSignalRepository::Load(const QString &filename
     bool okN = false, okF = false, okS = false;
     const int numSignals = parts[1].toInt(&okN);
     const int frequency = parts[2].toInt(&okF);
-    const int numSamples = parts[3].toInt(&okS);
+    const int64_t numSamples = parts[3].toLongLong(&okS);
 
     if (!okN || !okF || !okS || numSignals <= 0 || frequency <= 0 || numSamples <= 0) {
         std::cerr << "Error: Invalid numbers in header line: "
@@ -247,6 +285,15 @@ std::shared_ptr<SignalDataset> DATSignalRepository::Load(const QString &filename
 
     headerFile.close();
 
+    // Kanały, które trafią do zbioru danych (w trybie odprowadzeń niezależnych pomijamy III, aVR, aVL i aVF)
+    const bool derivedLimbLeads = independent_leads_only_ && is_standard_12_lead(leadNames);
+    std::vector<int> channels;
+    for (int ch = 0; ch < numSignals; ++ch) {
+        if (derivedLimbLeads && ch >= SignalDataset::III && ch <= SignalDataset::AVF) continue;
+        channels.push_back(ch);
+    }
+    const int numChannels = static_cast<int>(channels.size());
+
     QFile dataFile(dataPath);
     if (!dataFile.open(QIODevice::ReadOnly)) {
         std::cerr << "Error: Cannot open data file: "
@@ -287,20 +334,66 @@ std::shared_ptr<SignalDataset> DATSignalRepository::Load(const QString &filename
                 << std::endl;
     }
 
-    const int framesAvailable =
-            static_cast<int>(std::min<qsizetype>(totalFrames, numSamples));
+    const int64_t framesAvailable = std::min<int64_t>(totalFrames, numSamples);
     const int16_t *raw =
             reinterpret_cast<const int16_t *>(data.constData());
 
+    auto dataset = std::make_shared<SignalDataset>();
+    dataset->frequency = frequency;
+    dataset->derived_limb_leads = derivedLimbLeads;
+    if (parts.size() >= 6) dataset->start_time_us = parse_base_time(parts[4], parts[5]);
+    if (derivedLimbLeads) {
+        // Zależności między odprowadzeniami kończynowymi są dokładne w jednostkach przetwornika;
+        // przeliczamy je na jednostki fizyczne z wzmocnieniem i linią zerową każdego kanału
+        for (int d = 0; d < 4; ++d) {
+            const int ch = SignalDataset::III + d;
+            const double alpha = SignalDataset::DERIVED_LEAD_COMBINATION[d][0];
+            const double beta = SignalDataset::DERIVED_LEAD_COMBINATION[d][1];
+            dataset->derived_lead_weights[d][0] = static_cast<float>(alpha * gains[0] / gains[ch]);
+            dataset->derived_lead_weights[d][1] = static_cast<float>(beta * gains[1] / gains[ch]);
+            dataset->derived_lead_weights[d][2] = static_cast<float>(
+                (alpha * baselines[0] + beta * baselines[1] - baselines[ch]) / gains[ch]);
+        }
+    }
+    if (storage_ != SampleStorage::Float32 && framesAvailable == numSamples) {
+        // Zapis 16-bitowy: próbki trafiają wprost do CompactSignal, bez pośredniej kopii float.
+        // Int16 przechowuje surowe wartości przetwornika ze wzmocnieniem i linią zerową z nagłówka.
+        auto compact = std::make_shared<CompactSignal>(storage_, numSamples, numChannels);
+        for (int out = 0; out < numChannels; ++out)
+            compact->SetLeadScale(out, gains[channels[out]], baselines[channels[out]]);
+
+        for (int out = 0; out < numChannels; ++out) {
+            const int ch = channels[out];
+            for (int64_t i = 0; i < numSamples; ++i) {
+                const int16_t adc = raw[static_cast<qsizetype>(i) * numSignals + ch];
+                if (storage_ == SampleStorage::Int16) {
+                    compact->SetRaw(i, out, adc);
+                } else {
+                    compact->Set(i, out, static_cast<float>((static_cast<double>(adc) - baselines[ch]) / gains[ch]));
+                }
+            }
+        }
+        dataset->compact = compact;
+
+        std::cout << "Loaded " << numSamples << " samples x "
+                << numChannels << " channels"
+                << (derivedLimbLeads ? " (+4 derived limb leads)" : "")
+                << " (16-bit storage, " << compact->MemoryBytes() / 1024 << " KiB) at "
+                << dataset->frequency << " Hz from "
+                << filename.toStdString() << std::endl;
+        return dataset;
+    }
+
     std::vector<std::vector<float> > temp(framesAvailable,
-                                          std::vector<float>(numSignals, 0.0f));
+                                          std::vector<float>(numChannels, 0.0f));
 
     int nonFiniteCount = 0;
     const float NaN = std::numeric_limits<float>::quiet_NaN();
 
-    for (int i = 0; i < framesAvailable; ++i) {
+    for (int64_t i = 0; i < framesAvailable; ++i) {
         const qsizetype base = static_cast<qsizetype>(i) * numSignals;
-        for (int ch = 0; ch < numSignals; ++ch) {
+        for (int out = 0; out < numChannels; ++out) {
+            const int ch = channels[out];
             const qsizetype idx = base + ch;
             if (idx >= totalInt16) break;
 
@@ -314,19 +407,19 @@ std::shared_ptr<SignalDataset> DATSignalRepository::Load(const QString &filename
                 physical = NaN;
             }
 
-            temp[i][ch] = physical;
+            temp[i][out] = physical;
         }
     }
 
     if (nonFiniteCount > 0) {
-        for (int ch = 0; ch < numSignals; ++ch) {
+        for (int ch = 0; ch < numChannels; ++ch) {
             std::vector<float> col(framesAvailable);
-            for (int i = 0; i < framesAvailable; ++i)
+            for (int64_t i = 0; i < framesAvailable; ++i)
                 col[i] = temp[i][ch];
 
             interpolate_invalid_inplace(col);
 
-            for (int i = 0; i < framesAvailable; ++i)
+            for (int64_t i = 0; i < framesAvailable; ++i)
                 temp[i][ch] = col[i];
         }
 
@@ -335,34 +428,40 @@ std::shared_ptr<SignalDataset> DATSignalRepository::Load(const QString &filename
                 << std::endl;
     }
 
-    auto dataset = std::make_shared<SignalDataset>();
-    dataset->frequency = frequency;
     dataset->values.resize(numSamples);
 
     if (framesAvailable == numSamples) {
-        for (int i = 0; i < numSamples; ++i) {
+        for (int64_t i = 0; i < numSamples; ++i) {
             dataset->values[i].channelValues = temp[i];
         }
     } else {
-        for (int ch = 0; ch < numSignals; ++ch) {
+        for (int ch = 0; ch < numChannels; ++ch) {
             std::vector<float> src(framesAvailable);
-            for (int i = 0; i < framesAvailable; ++i)
+            for (int64_t i = 0; i < framesAvailable; ++i)
                 src[i] = temp[i][ch];
 
             std::vector<float> interp =
                     resample_linear(src, numSamples);
 
-            for (int i = 0; i < numSamples; ++i) {
+            for (int64_t i = 0; i < numSamples; ++i) {
                 if (dataset->values[i].channelValues.empty()) {
-                    dataset->values[i].channelValues.resize(numSignals, 0.0f);
+                    dataset->values[i].channelValues.resize(numChannels, 0.0f);
                 }
                 dataset->values[i].channelValues[ch] = interp[i];
             }
         }
     }
 
-    std::cout << "Loaded " << dataset->values.size() << " samples x "
-            << numSignals << " channels at "
+    if (storage_ != SampleStorage::Float32) {
+        // Brakujące próbki zostały uzupełnione w float - dopiero teraz zapis 16-bitowy
+        dataset->compact = std::make_shared<const CompactSignal>(
+            CompactSignal::FromDatapoints(dataset->values, storage_));
+        std::vector<SignalDatapoint>().swap(dataset->values);
+    }
+
+    std::cout << "Loaded " << numSamples << " samples x "
+            << numChannels << " channels"
+            << (derivedLimbLeads ? " (+4 derived limb leads)" : "") << " at "
             << dataset->frequency << " Hz from "
             << filename.toStdString() << std::endl;
 
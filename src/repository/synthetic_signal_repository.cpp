@@ -0,0 +1,537 @@
+#include "../../include/repository/synthetic_signal_repository.h"
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "../../include/model/signal_dataset.h"
+#include "../../include/util/parallel_for.h"
+#include "../../include/util/sample_time.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    constexpr size_t OUTPUT_LEADS = SignalDataset::STANDARD_LEAD_COUNT;
+    constexpr size_t MODELLED_LEADS = SignalDataset::INDEPENDENT_LEAD_COUNT;
+
+    // Odprowadzenia liczone z wektokardiogramu (kolejność kanałów trybu derived_limb_leads)
+    constexpr size_t MODELLED_LEAD_INDEX[MODELLED_LEADS] = {
+        SignalDataset::I, SignalDataset::II, SignalDataset::V1, SignalDataset::V2,
+        SignalDataset::V3, SignalDataset::V4, SignalDataset::V5, SignalDataset::V6
+    };
+
+    // Macierz Dowera (1988): X, Y, Z -> I, II, V1..V6
+    constexpr double DOWER[MODELLED_LEADS][3] = {
+        {0.632, -0.235, 0.059},
+        {0.235, 1.066, -0.132},
+        {-0.515, 0.157, -0.917},
+        {0.044, 0.164, -1.387},
+        {0.882, 0.098, -1.277},
+        {1.213, 0.127, -0.601},
+        {1.125, 0.127, -0.086},
+        {0.831, 0.076, 0.230}
+    };
+
+    const char* const LEAD_NAMES[OUTPUT_LEADS] = {
+        "i", "ii", "iii", "avr", "avl", "avf", "v1", "v2", "v3", "v4", "v5", "v6"
+    };
+
+    // Zdarzenie Gaussa w cyklu serca (jeden załamek)
+    struct WaveEvent {
+        double offset;       // położenie względem R [s] przy RR = 1 s
+        double width;        // odchylenie standardowe [s]
+        bool rate_scaled;    // położenie i szerokość skalowane √RR (P i T, nie QRS)
+        double amplitude[3]; // X, Y, Z [mV]
+    };
+
+    constexpr size_t WAVE_COUNT = 5;
+
+    // P, Q, R, S, T dla każdej klasy pobudzenia (indeks = BeatClass); amplituda 0 - brak załamka
+    constexpr WaveEvent MORPHOLOGY[3][WAVE_COUNT] = {
+        // Zatokowe: oś QRS w lewo, w dół i ku tyłowi, załamek T zgodny
+        {
+            {-0.20, 0.025, true, {0.10, 0.12, -0.02}},
+            {-0.025, 0.008, false, {-0.10, 0.0, -0.25}},
+            {0.0, 0.010, false, {1.10, 0.70, 0.50}},
+            {0.025, 0.010, false, {-0.25, -0.15, 0.10}},
+            {0.30, 0.060, true, {0.25, 0.20, -0.10}}
+        },
+        // Nadkomorowe: wcześniejszy P' z ogniska w dolnej części przedsionka (ujemny w II), QRS prawidłowy
+        {
+            {-0.16, 0.022, true, {0.06, -0.10, 0.02}},
+            {-0.025, 0.008, false, {-0.10, 0.0, -0.25}},
+            {0.0, 0.010, false, {1.10, 0.70, 0.50}},
+            {0.025, 0.010, false, {-0.25, -0.15, 0.10}},
+            {0.30, 0.060, true, {0.25, 0.20, -0.10}}
+        },
+        // Komorowe: bez P, szeroki QRS o innej osi i niezgodny załamek T
+        {
+            {0.0, 0.0, false, {0.0, 0.0, 0.0}},
+            {0.0, 0.0, false, {0.0, 0.0, 0.0}},
+            {0.0, 0.030, false, {-0.40, 1.20, -1.10}},
+            {0.06, 0.030, false, {0.50, -0.30, 0.40}},
+            {0.32, 0.070, true, {0.25, -0.35, 0.35}}
+        }
+    };
+
+    // Zasięg uderzenia względem R [s] (najdalsze zdarzenie ± 4 szerokości przy RR do 2 s)
+    constexpr double BEAT_BEFORE = 0.5;
+    constexpr double BEAT_AFTER = 0.9;
+    constexpr double EVENT_REACH = 4.0;
+
+    constexpr double MIN_RR = 0.25;
+    constexpr double MAX_RR = 2.0;
+    constexpr double SLOW_WANDER_FREQUENCY = 0.05; // [Hz]
+
+    // Próbki są liczone równolegle w blokach po RENDER_BLOCK, do ujścia trafiają partie po RENDER_BATCH bloków
+    constexpr size_t RENDER_BLOCK = 16384;
+    constexpr size_t RENDER_BATCH = 16;
+
+    // SplitMix64 z rozkładem normalnym metodą biegunową Marsaglii - ten sam ciąg na każdej platformie
+    // (rozkłady z <random> zależą od implementacji biblioteki)
+    class Random {
+        uint64_t state_;
+        bool has_spare_ = false;
+        double spare_ = 0.0;
+
+    public:
+        explicit Random(uint64_t seed) : state_(seed) {
+        }
+
+        uint64_t Next() {
+            uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            return z ^ (z >> 31);
+        }
+
+        // (0, 1]
+        double Uniform() { return static_cast<double>((Next() >> 11) + 1) * 0x1.0p-53; }
+
+        double Normal() {
+            if (has_spare_) {
+                has_spare_ = false;
+                return spare_;
+            }
+            double u, v, s;
+            do {
+                u = 2.0 * Uniform() - 1.0;
+                v = 2.0 * Uniform() - 1.0;
+                s = u * u + v * v;
+            } while (s >= 1.0 || s == 0.0);
+            const double factor = std::sqrt(-2.0 * std::log(s) / s);
+            spare_ = v * factor;
+            has_spare_ = true;
+            return u * factor;
+        }
+    };
+
+    uint64_t MixSeed(uint64_t seed, uint64_t stream) {
+        return Random(seed ^ (stream * 0xd1b54a32d192ed03ULL)).Next();
+    }
+
+    // Rezonator AR(2) pobudzany szumem białym: pasmo zmienności RR wokół zadanej częstotliwości.
+    // Częstotliwość i szerokość pasma w cyklach na uderzenie, odchylenie standardowe wyjścia w sekundach.
+    class Resonator {
+        double a1_ = 0.0, a2_ = 0.0, gain_ = 0.0;
+        double x1_ = 0.0, x2_ = 0.0;
+
+    public:
+        Resonator(double cycles_per_beat, double bandwidth_per_beat, double output_std) {
+            const double radius = std::exp(-M_PI * bandwidth_per_beat);
+            a1_ = 2.0 * radius * std::cos(2.0 * M_PI * std::min(cycles_per_beat, 0.49));
+            a2_ = -radius * radius;
+            // Wariancja stacjonarna procesu AR(2) dla jednostkowego pobudzenia
+            const double variance = (1.0 - a2_) / ((1.0 + a2_) * ((1.0 - a2_) * (1.0 - a2_) - a1_ * a1_));
+            gain_ = output_std / std::sqrt(variance);
+        }
+
+        double Step(Random& random) {
+            const double x = a1_ * x1_ + a2_ * x2_ + gain_ * random.Normal();
+            x2_ = x1_;
+            x1_ = x;
+            return x;
+        }
+    };
+
+    struct ScheduledBeat {
+        double r_time;    // [s]
+        double rate_scale; // √RR rytmu zatokowego
+        double amplitude;  // modulacja oddechowa i zmienność między uderzeniami
+        BeatClass beat_class;
+    };
+
+    // Sekwencyjny harmonogram uderzeń: odstępy RR z pasm LF i HF, pobudzenia przedwczesne
+    // (komorowe z pauzą wyrównawczą, nadkomorowe bez niej)
+    class BeatSchedule {
+        const SyntheticECGOptions& options_;
+        Random random_;
+        double mean_rr_;
+        Resonator lf_;
+        Resonator hf_;
+        double last_r_time_;
+        double pending_rr_ = 0.0;
+        bool previous_ectopic_ = false;
+        double respiration_phase_;
+
+    public:
+        explicit BeatSchedule(const SyntheticECGOptions& options)
+            : options_(options), random_(MixSeed(options.seed, 0)),
+              mean_rr_(60.0 / std::max(20.0, options.heart_rate)),
+              lf_(options.lf_frequency * mean_rr_, 0.02 * mean_rr_,
+                  options.hrv_std_ms / 1000.0 * std::sqrt(options.lf_hf_ratio / (1.0 + options.lf_hf_ratio))),
+              hf_(options.hf_frequency * mean_rr_, 0.02 * mean_rr_,
+                  options.hrv_std_ms / 1000.0 / std::sqrt(1.0 + options.lf_hf_ratio)) {
+            // Rozbieg rezonatorów do stanu stacjonarnego
+            for (int i = 0; i < 256; ++i) {
+                lf_.Step(random_);
+                hf_.Step(random_);
+            }
+            last_r_time_ = -mean_rr_ * random_.Uniform();
+            respiration_phase_ = 2.0 * M_PI * random_.Uniform();
+        }
+
+        ScheduledBeat Next() {
+            const double sinus_rr = std::clamp(mean_rr_ + lf_.Step(random_) + hf_.Step(random_), MIN_RR, MAX_RR);
+            const double ectopy = random_.Uniform();
+
+            double rr = sinus_rr;
+            BeatClass beat_class = BeatClass::Normal;
+            if (pending_rr_ > 0.0) {
+                rr = pending_rr_;
+                pending_rr_ = 0.0;
+            } else if (!previous_ectopic_ && ectopy <= options_.ventricular_ectopy) {
+                beat_class = BeatClass::Ventricular;
+                rr = 0.6 * sinus_rr;
+                pending_rr_ = 2.0 * sinus_rr - rr;
+            } else if (!previous_ectopic_ && ectopy <= options_.ventricular_ectopy + options_.supraventricular_ectopy) {
+                beat_class = BeatClass::Supraventricular;
+                rr = 0.7 * sinus_rr;
+            }
+            previous_ectopic_ = beat_class != BeatClass::Normal;
+
+            ScheduledBeat beat{};
+            beat.r_time = last_r_time_ + rr;
+            beat.rate_scale = std::sqrt(sinus_rr);
+            beat.amplitude = 1.0 + 0.05 * std::sin(2.0 * M_PI * options_.respiration_frequency * beat.r_time +
+                                                   respiration_phase_) + 0.02 * random_.Normal();
+            beat.beat_class = beat_class;
+            last_r_time_ = beat.r_time;
+            return beat;
+        }
+    };
+
+    // Stałe zakłóceń dla każdego modelowanego odprowadzenia (fazy losowane raz z ziarna)
+    struct Interference {
+        double respiration_cos[MODELLED_LEADS], respiration_sin[MODELLED_LEADS];
+        double slow_cos[MODELLED_LEADS], slow_sin[MODELLED_LEADS];
+        double powerline_cos[MODELLED_LEADS], powerline_sin[MODELLED_LEADS];
+
+        explicit Interference(uint64_t seed) {
+            Random random(MixSeed(seed, 1));
+            for (size_t lead = 0; lead < MODELLED_LEADS; ++lead) {
+                const double respiration = 2.0 * M_PI * random.Uniform();
+                const double slow = 2.0 * M_PI * random.Uniform();
+                const double powerline = 2.0 * M_PI * random.Uniform();
+                respiration_cos[lead] = std::cos(respiration);
+                respiration_sin[lead] = std::sin(respiration);
+                slow_cos[lead] = std::cos(slow);
+                slow_sin[lead] = std::sin(slow);
+                powerline_cos[lead] = std::cos(powerline);
+                powerline_sin[lead] = std::sin(powerline);
+            }
+        }
+    };
+
+    // sin i cos fazy 2π f t kolejnych próbek przez obrót o stały kąt (bez funkcji trygonometrycznych na próbkę)
+    class Oscillator {
+        double sin_, cos_, step_sin_, step_cos_;
+
+    public:
+        Oscillator(double frequency, int sampling_rate, int64_t first_sample) {
+            const double phase = 2.0 * M_PI * frequency * static_cast<double>(first_sample) / sampling_rate;
+            const double step = 2.0 * M_PI * frequency / sampling_rate;
+            sin_ = std::sin(phase);
+            cos_ = std::cos(phase);
+            step_sin_ = std::sin(step);
+            step_cos_ = std::cos(step);
+        }
+
+        double Sin() const { return sin_; }
+
+        double Cos() const { return cos_; }
+
+        void Advance() {
+            const double next_sin = sin_ * step_cos_ + cos_ * step_sin_;
+            cos_ = cos_ * step_cos_ - sin_ * step_sin_;
+            sin_ = next_sin;
+        }
+    };
+
+    // Liczy count próbek od first_sample do out (ramki po OUTPUT_LEADS odprowadzeń)
+    void RenderBlock(const SyntheticECGOptions& options, const Interference& interference,
+                     const std::vector<ScheduledBeat>& beats, int64_t first_sample, size_t count, float* out) {
+        Random noise(MixSeed(options.seed, 2 + static_cast<uint64_t>(first_sample) / RENDER_BLOCK));
+        const double fs = options.frequency;
+        const double first_time = static_cast<double>(first_sample) / fs;
+
+        size_t first_beat = static_cast<size_t>(
+            std::lower_bound(beats.begin(), beats.end(), first_time - BEAT_AFTER,
+                             [](const ScheduledBeat& beat, double time) { return beat.r_time < time; }) -
+            beats.begin());
+
+        Oscillator respiration(options.respiration_frequency, options.frequency, first_sample);
+        Oscillator slow(SLOW_WANDER_FREQUENCY, options.frequency, first_sample);
+        Oscillator powerline(options.powerline_frequency, options.frequency, first_sample);
+
+        for (size_t k = 0; k < count; ++k) {
+            const double t = static_cast<double>(first_sample + static_cast<int64_t>(k)) / fs;
+            while (first_beat < beats.size() && beats[first_beat].r_time < t - BEAT_AFTER) ++first_beat;
+
+            // Wektokardiogram: suma zdarzeń Gaussa uderzeń, których zasięg obejmuje t
+            double vcg[3] = {0.0, 0.0, 0.0};
+            for (size_t b = first_beat; b < beats.size() && beats[b].r_time <= t + BEAT_BEFORE; ++b) {
+                const ScheduledBeat& beat = beats[b];
+                const double dt = t - beat.r_time;
+                for (const WaveEvent& wave : MORPHOLOGY[static_cast<size_t>(beat.beat_class)]) {
+                    if (wave.width <= 0.0) continue;
+                    const double scale = wave.rate_scaled ? beat.rate_scale : 1.0;
+                    const double width = wave.width * scale;
+                    const double distance = dt - wave.offset * scale;
+                    if (std::fabs(distance) > EVENT_REACH * width) continue;
+                    const double weight = beat.amplitude * std::exp(-0.5 * distance * distance / (width * width));
+                    vcg[0] += weight * wave.amplitude[0];
+                    vcg[1] += weight * wave.amplitude[1];
+                    vcg[2] += weight * wave.amplitude[2];
+                }
+            }
+
+            const double respiration_sin = respiration.Sin(), respiration_cos = respiration.Cos();
+            const double slow_sin = slow.Sin(), slow_cos = slow.Cos();
+            const double powerline_sin = powerline.Sin(), powerline_cos = powerline.Cos();
+            respiration.Advance();
+            slow.Advance();
+            powerline.Advance();
+
+            float* frame = out + k * OUTPUT_LEADS;
+            for (size_t lead = 0; lead < MODELLED_LEADS; ++lead) {
+                // sin(a + φ) = sin a · cos φ + cos a · sin φ - wspólne sinusy dla wszystkich odprowadzeń
+                const double wander =
+                    0.7 * (respiration_sin * interference.respiration_cos[lead] +
+                           respiration_cos * interference.respiration_sin[lead]) +
+                    0.3 * (slow_sin * interference.slow_cos[lead] + slow_cos * interference.slow_sin[lead]);
+                const double mains = powerline_sin * interference.powerline_cos[lead] +
+                                     powerline_cos * interference.powerline_sin[lead];
+                const double value = DOWER[lead][0] * vcg[0] + DOWER[lead][1] * vcg[1] + DOWER[lead][2] * vcg[2] +
+                                     options.baseline_wander * wander + options.powerline_amplitude * mains +
+                                     options.noise_std * noise.Normal();
+                frame[MODELLED_LEAD_INDEX[lead]] = static_cast<float>(value);
+            }
+
+            // Odprowadzenia kończynowe z tych samych elektrod (razem z ich zakłóceniami)
+            const float lead_i = frame[SignalDataset::I];
+            const float lead_ii = frame[SignalDataset::II];
+            frame[SignalDataset::III] = lead_ii - lead_i;
+            frame[SignalDataset::AVR] = -0.5f * (lead_i + lead_ii);
+            frame[SignalDataset::AVL] = lead_i - 0.5f * lead_ii;
+            frame[SignalDataset::AVF] = lead_ii - 0.5f * lead_i;
+        }
+    }
+
+    // Generuje cały zapis partiami i przekazuje je do sink(pierwsza próbka, liczba próbek, ramki)
+    void Generate(const SyntheticECGOptions& options, int64_t total, std::vector<SyntheticBeat>& annotations,
+                  const std::function<void(int64_t, size_t, const float*)>& sink) {
+        BeatSchedule schedule(options);
+        const Interference interference(options.seed);
+        std::vector<ScheduledBeat> beats;
+        std::vector<float> buffer;
+        annotations.clear();
+
+        const int64_t batch_samples = static_cast<int64_t>(RENDER_BLOCK * RENDER_BATCH);
+        for (int64_t batch_start = 0; batch_start < total; batch_start += batch_samples) {
+            const size_t batch_count = static_cast<size_t>(std::min(batch_samples, total - batch_start));
+            const double batch_end_time = static_cast<double>(batch_start + static_cast<int64_t>(batch_count)) /
+                                          options.frequency + BEAT_BEFORE;
+            while (beats.empty() || beats.back().r_time <= batch_end_time) {
+                beats.push_back(schedule.Next());
+                const int64_t r_peak = SecondsToSample(beats.back().r_time, options.frequency);
+                if (r_peak >= 0 && r_peak < total) annotations.push_back({r_peak, beats.back().beat_class});
+            }
+
+            buffer.resize(batch_count * OUTPUT_LEADS);
+            const size_t blocks = (batch_count + RENDER_BLOCK - 1) / RENDER_BLOCK;
+            ParallelFor(blocks, [&](size_t block) {
+                const size_t from = block * RENDER_BLOCK;
+                RenderBlock(options, interference, beats, batch_start + static_cast<int64_t>(from),
+                            std::min(RENDER_BLOCK, batch_count - from), buffer.data() + from * OUTPUT_LEADS);
+            });
+            sink(batch_start, batch_count, buffer.data());
+        }
+    }
+
+    // Próbka przetwornika (format 16 i zapis Int16): ta sama kwantyzacja w Load i Write
+    int16_t Quantize(float value, double gain) {
+        const double scaled = std::round(static_cast<double>(value) * gain);
+        return static_cast<int16_t>(std::clamp(scaled, -32768.0, 32767.0));
+    }
+
+    // Czas początku zapisu w formacie linii rekordu WFDB: " HH:MM:SS DD/MM/YYYY"
+    std::string FormatBaseTime(int64_t start_time_us) {
+        const int64_t seconds = FloorDivide(start_time_us, MICROSECONDS_PER_SECOND);
+        const int64_t microseconds = start_time_us - seconds * MICROSECONDS_PER_SECOND;
+        const int64_t days = FloorDivide(seconds, 86400);
+        const int64_t second_of_day = seconds - days * 86400;
+        int64_t year = 0;
+        int month = 0, day = 0;
+        CivilFromDays(days, year, month, day);
+
+        char text[64];
+        const int hours = static_cast<int>(second_of_day / 3600);
+        const int minutes = static_cast<int>(second_of_day / 60 % 60);
+        if (microseconds == 0) {
+            std::snprintf(text, sizeof(text), " %02d:%02d:%02d %02d/%02d/%04lld", hours, minutes,
+                          static_cast<int>(second_of_day % 60), day, month, static_cast<long long>(year));
+        } else {
+            std::snprintf(text, sizeof(text), " %02d:%02d:%09.6f %02d/%02d/%04lld", hours, minutes,
+                          static_cast<double>(second_of_day % 60) + microseconds * 1e-6, day, month,
+                          static_cast<long long>(year));
+        }
+        return text;
+    }
+}
+
+SyntheticSignalRepository::SyntheticSignalRepository(SyntheticECGOptions options, SampleStorage storage)
+    : options_(options), storage_(storage) {
+}
+
+int64_t SyntheticSignalRepository::SampleCount() const {
+    if (options_.frequency <= 0 || options_.duration_seconds <= 0.0) return 0;
+    return SecondsToSample(options_.duration_seconds, options_.frequency);
+}
+
+std::shared_ptr<SignalDataset> SyntheticSignalRepository::Load(const QString& source) {
+    const int64_t total = SampleCount();
+    if (total <= 0) {
+        std::cerr << "Error: Invalid synthetic record parameters (frequency/duration)" << std::endl;
+        return std::make_shared<SignalDataset>();
+    }
+
+    auto dataset = std::make_shared<SignalDataset>();
+    dataset->frequency = options_.frequency;
+    dataset->start_time_us = options_.start_time_us;
+    dataset->derived_limb_leads = options_.independent_leads_only;
+
+    // Kanały zbioru danych: wszystkie 12 odprowadzeń albo tylko niezależne
+    std::vector<size_t> channels;
+    for (size_t lead = 0; lead < OUTPUT_LEADS; ++lead)
+        if (!options_.independent_leads_only || SignalDataset::StorageIndex(lead, true) >= 0) channels.push_back(lead);
+    const size_t channel_count = channels.size();
+
+    std::shared_ptr<CompactSignal> compact;
+    if (storage_ == SampleStorage::Float32) {
+        dataset->values.resize(static_cast<size_t>(total));
+        for (auto& datapoint : dataset->values) datapoint.channelValues.resize(channel_count);
+    } else {
+        compact = std::make_shared<CompactSignal>(storage_, static_cast<size_t>(total), channel_count);
+        if (storage_ == SampleStorage::Int16)
+            for (size_t c = 0; c < channel_count; ++c) compact->SetLeadScale(c, options_.adc_gain, 0.0);
+        dataset->compact = compact;
+    }
+
+    Generate(options_, total, beats_, [&](int64_t first, size_t count, const float* frames) {
+        for (size_t k = 0; k < count; ++k) {
+            const float* frame = frames + k * OUTPUT_LEADS;
+            const size_t sample = static_cast<size_t>(first) + k;
+            if (storage_ == SampleStorage::Int16) {
+                for (size_t c = 0; c < channel_count; ++c)
+                    compact->SetRaw(sample, c, Quantize(frame[channels[c]], options_.adc_gain));
+            } else if (compact) {
+                for (size_t c = 0; c < channel_count; ++c) compact->Set(sample, c, frame[channels[c]]);
+            } else {
+                float* values = dataset->values[sample].channelValues.data();
+                for (size_t c = 0; c < channel_count; ++c) values[c] = frame[channels[c]];
+            }
+        }
+    });
+
+    std::cout << "Generated " << total << " samples x " << channel_count << " channels"
+            << (options_.independent_leads_only ? " (+4 derived limb leads)" : "") << " at "
+            << dataset->frequency << " Hz, " << beats_.size() << " beats (" << source.toStdString() << ")"
+            << std::endl;
+    return dataset;
+}
+
+bool SyntheticSignalRepository::Write(const QString& path) {
+    const int64_t total = SampleCount();
+    if (total <= 0) {
+        std::cerr << "Error: Invalid synthetic record parameters (frequency/duration)" << std::endl;
+        return false;
+    }
+
+    const QFileInfo info(path);
+    const QString base_name = info.completeBaseName();
+    const QString base_path = info.absolutePath() + "/" + base_name;
+
+    QFile data_file(base_path + ".dat");
+    if (!data_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        std::cerr << "Error: Cannot create data file: " << (base_path + ".dat").toStdString() << std::endl;
+        return false;
+    }
+
+    // Format 16: próbki int16 little endian, ramka po ramce; suma kontrolna i pierwsza wartość do nagłówka
+    int16_t first_values[OUTPUT_LEADS] = {};
+    int64_t checksums[OUTPUT_LEADS] = {};
+    std::vector<char> bytes;
+    bool ok = true;
+    Generate(options_, total, beats_, [&](int64_t first, size_t count, const float* frames) {
+        if (!ok) return;
+        bytes.resize(count * OUTPUT_LEADS * 2);
+        for (size_t i = 0; i < count * OUTPUT_LEADS; ++i) {
+            const int16_t raw = Quantize(frames[i], options_.adc_gain);
+            const size_t lead = i % OUTPUT_LEADS;
+            if (first == 0 && i < OUTPUT_LEADS) first_values[lead] = raw;
+            checksums[lead] += raw;
+            bytes[2 * i] = static_cast<char>(static_cast<uint16_t>(raw) & 0xff);
+            bytes[2 * i + 1] = static_cast<char>(static_cast<uint16_t>(raw) >> 8);
+        }
+        ok = data_file.write(bytes.data(), static_cast<qint64>(bytes.size())) == static_cast<qint64>(bytes.size());
+    });
+    data_file.close();
+    if (!ok) {
+        std::cerr << "Error: Cannot write data file: " << (base_path + ".dat").toStdString() << std::endl;
+        return false;
+    }
+
+    const std::string name = base_name.toStdString();
+    std::string header = name + " " + std::to_string(OUTPUT_LEADS) + " " + std::to_string(options_.frequency) +
+                         " " + std::to_string(total);
+    if (options_.start_time_us != SignalDataset::NO_START_TIME) header += FormatBaseTime(options_.start_time_us);
+    header += "\n";
+    for (size_t lead = 0; lead < OUTPUT_LEADS; ++lead) {
+        char line[160];
+        std::snprintf(line, sizeof(line), "%s.dat 16 %g(0)/mV 16 0 %d %d 0 %s\n", name.c_str(), options_.adc_gain,
+                      first_values[lead], static_cast<int16_t>(checksums[lead] & 0xffff), LEAD_NAMES[lead]);
+        header += line;
+    }
+
+    QFile header_file(base_path + ".hea");
+    if (!header_file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+        header_file.write(header.data(), static_cast<qint64>(header.size())) != static_cast<qint64>(header.size())) {
+        std::cerr << "Error: Cannot write header file: " << (base_path + ".hea").toStdString() << std::endl;
+        return false;
+    }
+    header_file.close();
+
+    std::cout << "Wrote " << total << " samples x " << OUTPUT_LEADS << " channels at " << options_.frequency
+            << " Hz, " << beats_.size() << " beats to " << base_path.toStdString() << ".dat" << std::endl;
+    return true;
+}
@@ -1,5 +1,6 @@
 #include "../../include/service/application_service.h"
 
+#include <algorithm>
 #include <iostream>
 #include <ostream>
 
@@ -10,38 +11,98 @@ ApplicationService::ApplicationService(
     std::shared_ptr<IFilterService> butterworth_filter_service,
     std::shared_ptr<IFilterService> moving_average_filter_service,
     std::shared_ptr<IRPeaksDetectionService> r_peaks_detection_service,
+    std::shared_ptr<ISignalQualityService> signal_quality_service,
     std::shared_ptr<IHRVTimeProcessingService> hrv_time_processing_service,
     std::shared_ptr<IHRVGeoProcessingService> hrv_geo_processing_service,
     std::shared_ptr<IHRVDFAProcessingService> hrv_dfa_processing_service,
+    std::shared_ptr<IHRVNonlinearProcessingService> hrv_nonlinear_processing_service,
     std::shared_ptr<IWavesDetectionService> waves_detection_service,
-    std::shared_ptr<IHeartClassDetectionService> heart_class_detection_service
+    std::shared_ptr<IHeartClassDetectionService> heart_class_detection_service,
+    std::shared_ptr<IBeatTemplateService> beat_template_service,
+    std::shared_ptr<IVectorcardiogramService> vectorcardiogram_service
 )
     : signal_repository_(std::move(signal_repository)),
       butterworth_filter_service_(std::move(butterworth_filter_service)),
       moving_average_filter_service_(std::move(moving_average_filter_service)),
       r_peaks_detection_service_(std::move(r_peaks_detection_service)),
+      signal_quality_service_(std::move(signal_quality_service)),
       hrv_time_processing_service_(std::move(hrv_time_processing_service)),
       hrv_geo_processing_service_(std::move(hrv_geo_processing_service)),
       hrv_dfa_processing_service_(std::move(hrv_dfa_processing_service)),
+      hrv_nonlinear_processing_service_(std::move(hrv_nonlinear_processing_service)),
       heart_class_detection_service_(std::move(heart_class_detection_service)),
-      waves_detection_service_(std::move(waves_detection_service)) {
+      waves_detection_service_(std::move(waves_detection_service)),
+      beat_template_service_(std::move(beat_template_service)),
+      vectorcardiogram_service_(std::move(vectorcardiogram_service)) {
 }
 
 bool ApplicationService::Load(const QString &filename) {
     const auto dataset = signal_repository_->Load(filename);
-    const auto filtered_signal_dataset = butterworth_filter_service_->Filter(dataset->values);
+    // Moduły czytające surowy sygnał (filtr, ocena jakości) biorą zbiór danych - zapis 16-bitowy jest
+    // rozwijany do float blokami, więc w pamięci nie powstaje pełna kopia surowego sygnału
+    const auto filtered_signal_dataset = butterworth_filter_service_->Filter(*dataset);
     // Tymczasowo, po prostu uruchamiamy filtr butterwortha i uruchamiamy kolejne moduły. Docelowo będzie od tego przycisk, który podepnie się na końcu.
-    // moving_average_filter_service_->Filter(dataset->values);
+    // moving_average_filter_service_->Filter(*dataset);
     const auto detected_r_peaks = r_peaks_detection_service_->Detect(filtered_signal_dataset, dataset->frequency);
-    hrv_time_processing_service_->Process(filtered_signal_dataset, detected_r_peaks, dataset->frequency);
-    hrv_dfa_processing_service_->Process(filtered_signal_dataset, dataset->frequency);
-    hrv_geo_processing_service_->Process(detected_r_peaks, dataset->frequency);
-    heart_class_detection_service_->Detect(filtered_signal_dataset, dataset->frequency);
-    waves_detection_service_->Detect(filtered_signal_dataset, dataset->frequency);
+    // Wektokardiogram (pusty, jeśli zapis nie ma standardowych 12 odprowadzeń)
+    vectorcardiogram_ = vectorcardiogram_service_->Derive(filtered_signal_dataset, dataset->frequency,
+                                                          dataset->derived_limb_leads);
+    signal_quality_ = signal_quality_service_->Assess(*dataset, detected_r_peaks);
+    // Seria RR jest wyznaczana raz i współdzielona przez moduły HRV. Odstępy w segmentach o złej jakości
+    // są oznaczane w serii i nie wchodzą do metryk.
+    rr_series_ = RRSeries::FromPeaks(detected_r_peaks, dataset->frequency, &signal_quality_);
+    hrv_time_processing_service_->Process(rr_series_);
+    hrv_dfa_processing_service_->Process(rr_series_);
+    hrv_geo_processing_service_->Process(rr_series_);
+    hrv_nonlinear_processing_service_->Process(rr_series_);
+
+    // Dalsze moduły tylko dla uderzeń z przydatnych segmentów. Ciągłe odcinki przydatnego sygnału są
+    // wyznaczane osobno, a ich granice trafiają do klasyfikacji, żeby ani okna załamków, ani cechy RR
+    // nie opierały się na odstępach przeskakujących przez odrzucony fragment (elektroda odłączona, nasycenie).
+    beat_fiducials_.clear();
+    std::vector<size_t> run_starts;
+    std::vector<int64_t> run;
+    auto flush_run = [&]() {
+        if (run.empty()) return;
+        const auto fiducials = waves_detection_service_->Detect(filtered_signal_dataset, run, dataset->frequency);
+        if (!fiducials.empty() && !beat_fiducials_.empty()) run_starts.push_back(beat_fiducials_.size());
+        beat_fiducials_.insert(beat_fiducials_.end(), fiducials.begin(), fiducials.end());
+        run.clear();
+    };
+    for (const int64_t peak: rr_series_.peaks) {
+        if (!signal_quality_.IsUsable(peak)) {
+            flush_run();
+            continue;
+        }
+        // Odcinek kończy się też na nieprzydatnym segmencie bez wykrytych pików
+        if (!run.empty() && signal_quality_.segment_length > 0) {
+            const int64_t segment_length = signal_quality_.segment_length;
+            for (int64_t segment = run.back() / segment_length + 1; segment < peak / segment_length; ++segment) {
+                if (!signal_quality_.IsUsable(segment * segment_length)) {
+                    flush_run();
+                    break;
+                }
+            }
+        }
+        run.push_back(peak);
+    }
+    flush_run();
+
+    heart_class_result_ = heart_class_detection_service_->Detect(filtered_signal_dataset, beat_fiducials_,
+                                                                 dataset->frequency, run_starts);
+
+    // Wzorce uderzenia tylko z pobudzeń prawidłowych
+    std::vector<int64_t> normal_peaks;
+    for (size_t i = 0; i < beat_fiducials_.size(); ++i)
+        if (heart_class_result_.labels[i] == BeatClass::Normal) normal_peaks.push_back(beat_fiducials_[i].r_peak);
+    beat_templates_ = beat_template_service_->Compute(filtered_signal_dataset, normal_peaks, dataset->frequency,
+                                                      dataset->derived_limb_leads);
+    if (!vectorcardiogram_.Empty())
+        spatial_qrs_t_angle_ = vectorcardiogram_service_->SpatialQRSTAngle(vectorcardiogram_, beat_fiducials_);
     // TODO(Mati W.): trzeba uzupełnić
 }
 
-int ApplicationService::GetLength() const {
+int64_t ApplicationService::GetLength() const {
     // TODO(Mati W.): trzeba uzupełnić
 }
 
@@ -72,3 +133,8 @@ bool ApplicationService::RunFiltering(FilterMethod method) {
 int ApplicationService::GetFrequency() const {
     // TODO(Mati W.): trzeba uzupełnić
 }
+
+
+SignalQuality ApplicationService::GetSignalQuality() const {
+    return signal_quality_;
+}
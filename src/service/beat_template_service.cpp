@@ -0,0 +1,97 @@
+#include "../../include/service/beat_template_service.h"
+#include <algorithm>
+#include <cmath>
+
+#include "../../include/util/parallel_for.h"
+
+namespace {
+    // Liczba niezależnych sum częściowych przy sumowaniu wiersza - pozwala kompilatorowi wektoryzować pętlę
+    constexpr size_t LANES = 8;
+
+    // Liczba uderzeń kopiowanych razem do macierzy wzorców (16 liczb float to jedna linia pamięci podręcznej)
+    constexpr size_t BEAT_TILE = 16;
+
+    float RowMean(const float* row, size_t count) {
+        float partial[LANES] = {};
+        size_t i = 0;
+        for (; i + LANES <= count; i += LANES)
+            for (size_t lane = 0; lane < LANES; ++lane) partial[lane] += row[i + lane];
+        double sum = 0.0;
+        for (; i < count; ++i) sum += row[i];
+        for (float p : partial) sum += p;
+        return static_cast<float>(sum / static_cast<double>(count));
+    }
+
+    // Mediana przez wybór elementu środkowego; zmienia kolejność elementów wiersza
+    float RowMedian(float* row, size_t count) {
+        float* middle = row + count / 2;
+        std::nth_element(row, middle, row + count);
+        if (count % 2 == 1) return *middle;
+        // Po nth_element wszystkie elementy przed middle są nie większe - największy z nich to drugi środkowy
+        return 0.5f * (*middle + *std::max_element(row, middle));
+    }
+}
+
+BeatTemplateService::BeatTemplateService(double seconds_before, double seconds_after, size_t max_beats)
+    : seconds_before_(seconds_before), seconds_after_(seconds_after), max_beats_(std::max<size_t>(1, max_beats)) {
+}
+
+BeatTemplates BeatTemplateService::Compute(const std::vector<SignalDatapoint>& datapoints,
+                                           const std::vector<int64_t>& r_peaks, int frequency,
+                                           bool derived_limb_leads) {
+    BeatTemplates templates;
+    templates.frequency = frequency;
+    templates.derived_limb_leads = derived_limb_leads;
+    if (datapoints.empty() || r_peaks.empty() || frequency <= 0) return templates;
+
+    const int64_t before = std::lround(seconds_before_ * frequency);
+    const int64_t after = std::lround(seconds_after_ * frequency);
+    const size_t length = static_cast<size_t>(before + after + 1);
+    const size_t lead_count = datapoints.front().channelValues.size();
+    templates.r_offset = before;
+    templates.length = length;
+    templates.lead_count = lead_count;
+
+    // Tylko uderzenia, których całe okno mieści się w sygnale
+    const int64_t size = static_cast<int64_t>(datapoints.size());
+    std::vector<int64_t> usable;
+    usable.reserve(r_peaks.size());
+    for (int64_t r : r_peaks)
+        if (r - before >= 0 && r + after < size) usable.push_back(r);
+    if (usable.empty()) return templates;
+
+    // Przy dłuższych zapisach - max_beats_ uderzeń równomiernie rozłożonych w całym zapisie
+    std::vector<int64_t> selected;
+    if (usable.size() > max_beats_) {
+        selected.resize(max_beats_);
+        for (size_t b = 0; b < max_beats_; ++b) selected[b] = usable[b * usable.size() / max_beats_];
+    } else {
+        selected = std::move(usable);
+    }
+    const size_t beats = selected.size();
+    templates.beat_count = beats;
+
+    // Macierz [odprowadzenie][próbka wzorca][uderzenie] - wiersz (odprowadzenie, próbka) jest ciągły
+    std::vector<float> matrix(lead_count * length * beats);
+    // Uderzenia są kopiowane paczkami po BEAT_TILE, żeby zapisy do wiersza macierzy trafiały w tę samą linię pamięci
+    ParallelForRange(beats, BEAT_TILE, [&](size_t from, size_t to) {
+        for (size_t k = 0; k < length; ++k) {
+            for (size_t b = from; b < to; ++b) {
+                const std::vector<float>& values = datapoints[selected[b] - before + k].channelValues;
+                for (size_t lead = 0; lead < lead_count; ++lead)
+                    matrix[(lead * length + k) * beats + b] = values[lead];
+            }
+        }
+    });
+
+    templates.mean.resize(lead_count * length);
+    templates.median.resize(lead_count * length);
+    ParallelForRange(lead_count * length, 64, [&](size_t from, size_t to) {
+        for (size_t row = from; row < to; ++row) {
+            float* values = &matrix[row * beats];
+            templates.mean[row] = RowMean(values, beats);
+            templates.median[row] = RowMedian(values, beats);
+        }
+    });
+    return templates;
+}
@@ -1,10 +1,69 @@
 #include "../../include/service/butterworth_filter_service.h"
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
+namespace {
+    // Liczba próbek czytanych naraz z zapisu 16-bitowego
+    constexpr size_t FILTER_BLOCK = 65536;
+
+    constexpr double CUTOFF_FREQUENCY = 40.0; // częstotliwość odcięcia [Hz]
+
+    // Filtr IIR 2 rzędu ze stanem zachowywanym między kolejnymi blokami próbek
+    class ButterworthSection {
+        double b0_, b1_, b2_, a1_, a2_;
+        std::vector<double> x1_, x2_, y1_, y2_;
+
+    public:
+        ButterworthSection(size_t numChannels, double fs) {
+            // Parametry filtru Butterwortha
+            double fc = CUTOFF_FREQUENCY; //częstotliwość odcięcia
+            double K = tan(M_PI * fc / fs); //przekszt. bilinearne: zamiana filtru analogowego na dyskretny
+            double K2 = K * K;
+            double norm = 1.0 / (1.0 + std::sqrt(2.0) * K + K2); //współczynnik normalizujący amplitudę
+
+            // Oblicz współczynniki
+            b0_ = K2 * norm;
+            b1_ = 2.0 * b0_;
+            b2_ = b0_;
+            a1_ = 2.0 * (K2 - 1.0) * norm;
+            a2_ = (1.0 - std::sqrt(2.0) * K + K2) * norm;
+
+            // wartości startwe, x1- wej. z poprzedniego kroku, y1- poprzednia wart. wyj
+            x1_.assign(numChannels, 0.0);
+            x2_.assign(numChannels, 0.0);
+            y1_.assign(numChannels, 0.0);
+            y2_.assign(numChannels, 0.0);
+        }
+
+        // Równanie dla filtru IIR: y[n]=b0?x[n]+b1?x[n?1]+b2?x[n?2]?a1?y[n?1]?a2?y[n?2], gdzie x[n] to aktualny sygnał
+        void Process(const SignalDatapoint* values, size_t count, SignalDatapoint* filtered) {
+            const size_t numChannels = x1_.size();
+            for (size_t i = 0; i < count; ++i) {
+                filtered[i].channelValues.resize(numChannels);
+
+                for (size_t ch = 0; ch < numChannels; ++ch) {
+                    double x0 = values[i].channelValues[ch];
+                    double y0 = b0_ * x0 + b1_ * x1_[ch] + b2_ * x2_[ch] - a1_ * y1_[ch] - a2_ * y2_[ch];
+
+                    x2_[ch] = x1_[ch];
+                    x1_[ch] = x0;
+                    y2_[ch] = y1_[ch];
+                    y1_[ch] = y0;
+
+                    filtered[i].channelValues[ch] = static_cast<float>(y0);
+                }
+            }
+        }
+    };
+}
+
+ButterworthFilterService::ButterworthFilterService(int frequency) : frequency_(frequency) {
+}
+
 std::vector<SignalDatapoint> ButterworthFilterService::Filter(const std::vector<SignalDatapoint>& values) {
     std::vector<SignalDatapoint> filtered(values.size()); // tworzenie nowego wektora filtered- nowy wynik
 
@@ -14,47 +73,34 @@ std::vector<SignalDatapoint> ButterworthFilterService::Filter(const std::vector<
     if (values.empty() || values[0].channelValues.empty())
         return values;
 
-    const size_t numChannels = values[0].channelValues.size();
-
-    // Parametry filtru Butterwortha
-    double fs = 500.0; //częstotliwość próbkowania
-    double fc = 40.0; //częstotliwość odcięcia
-    double K = tan(M_PI * fc / fs); //przekszt. bilinearne: zamiana filtru analogowego na dyskretny
-    double K2 = K * K;
-    double norm = 1.0 / (1.0 + std::sqrt(2.0) * K + K2); //współczynnik normalizujący amplitudę
-
-    // Oblicz współczynniki
-    double b0 = K2 * norm;
-    double b1 = 2.0 * b0;
-    double b2 = b0;
-    double a1 = 2.0 * (K2 - 1.0) * norm;
-    double a2 = (1.0 - std::sqrt(2.0) * K + K2) * norm;
-
-    // Równanie dla filtru IIR: y[n]=b0?x[n]+b1?x[n?1]+b2?x[n?2]?a1?y[n?1]?a2?y[n?2], gdzie x[n] to aktualny sygnał
-    // wartości startwe, x1- wej. z poprzedniego kroku, y1- poprzednia wart. wyj
-    std::vector<double> x1(numChannels, 0.0);
-    std::vector<double> x2(numChannels, 0.0);
-    std::vector<double> y1(numChannels, 0.0);
-    std::vector<double> y2(numChannels, 0.0);
-
-    for (size_t i = 0; i < values.size(); ++i) {
-        filtered[i].channelValues.resize(numChannels);
-
-        for (size_t ch = 0; ch < numChannels; ++ch) {
-            double x0 = values[i].channelValues[ch];
-            double y0 = b0 * x0 + b1 * x1[ch] + b2 * x2[ch] - a1 * y1[ch] - a2 * y2[ch];
-
-            x2[ch] = x1[ch];
-            x1[ch] = x0;
-            y2[ch] = y1[ch];
-            y1[ch] = y0;
-
-            filtered[i].channelValues[ch] = static_cast<float>(y0);
-        }
-    }
+    // Odcięcie musi leżeć poniżej częstotliwości Nyquista
+    if (frequency_ <= 2.0 * CUTOFF_FREQUENCY)
+        return values;
+
+    ButterworthSection section(values[0].channelValues.size(), frequency_);
+    section.Process(values.data(), values.size(), filtered.data());
 
     std::cout << "Butterworth filter finished" << std::endl;
 
     return filtered;
 }
 
+std::vector<SignalDatapoint> ButterworthFilterService::Filter(const SignalDataset& dataset) {
+    if (!dataset.compact) return ButterworthFilterService(dataset.frequency).Filter(dataset.values);
+
+    const size_t n = dataset.Size();
+    if (n < 3 || dataset.ChannelCount() == 0 || dataset.frequency <= 2.0 * CUTOFF_FREQUENCY)
+        return dataset.Samples(0, n);
+
+    // Zapis 16-bitowy - bloki rozwijane do float tylko na czas filtracji, stan filtru przechodzi między blokami
+    std::vector<SignalDatapoint> filtered(n);
+    ButterworthSection section(dataset.ChannelCount(), dataset.frequency);
+    for (size_t from = 0; from < n; from += FILTER_BLOCK) {
+        const std::vector<SignalDatapoint> block = dataset.Samples(from, std::min(FILTER_BLOCK, n - from));
+        section.Process(block.data(), block.size(), filtered.data() + from);
+    }
+
+    std::cout << "Butterworth filter finished" << std::endl;
+
+    return filtered;
+}
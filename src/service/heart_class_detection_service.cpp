@@ -1,6 +1,276 @@
 #include "../../include/service/heart_class_detection_service.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
-HeartClassResult HeartClassDetectionService::Detect(const std::vector<SignalDatapoint> &datapoints, int frequency) {
-    // TODO(Jeremiasz): trzeba uzupełnić
-    return HeartClassResult{};
+#include "../../include/model/beat_clusterer.h"
+#include "../../include/util/aligned_allocator.h"
+#include "../../include/util/parallel_for.h"
+
+namespace {
+    // Kolumny macierzy cech (wiersz na uderzenie)
+    enum Feature : uint8_t {
+        PRE_RR = 0,          // odstęp RR przed uderzeniem / lokalna mediana RR
+        POST_RR = 1,         // odstęp RR po uderzeniu / lokalna mediana RR
+        QRS_WIDTH = 2,       // szerokość QRS [ms]
+        QRS_WIDTH_RATIO = 3, // szerokość QRS / mediana szerokości w zapisie
+        CORRELATION = 4,     // korelacja wzorca grupy uderzenia z wzorcem grupy dominującej
+        AMPLITUDE = 5,       // amplituda morfologii / mediana amplitudy grupy dominującej
+        MORPHOLOGY = 8       // początek zdecymowanej morfologii QRS (MORPHOLOGY_POINTS kolumn, od granicy 32 B)
+    };
+
+    constexpr size_t MORPHOLOGY_POINTS = 32;
+    // Wiersz ma długość wielokrotności 8 liczb float (32 B), a macierz zaczyna się na granicy 32 B
+    // (FeatureMatrix), więc każdy wiersz i kolumna MORPHOLOGY leżą na granicy 32 B
+    constexpr size_t FEATURE_ALIGNMENT = 32;
+    constexpr size_t FEATURE_STRIDE = (MORPHOLOGY + MORPHOLOGY_POINTS + 7) / 8 * 8;
+    using FeatureMatrix = AlignedVector<float, FEATURE_ALIGNMENT>;
+
+    // Grupowanie morfologii: minimalna korelacja z wzorcem grupy i limit liczby grup
+    constexpr double CLUSTER_CORRELATION = 0.9;
+    constexpr size_t MAX_CLUSTERS = 64;
+
+    // Okno morfologii względem piku R [s], dzielone na MORPHOLOGY_POINTS przedziałów uśrednianych
+    constexpr double MORPHOLOGY_BEFORE = 0.10;
+    constexpr double MORPHOLOGY_AFTER = 0.15;
+
+    // Lokalna mediana RR z odstępów [i - LOCAL_RR_RADIUS, i + LOCAL_RR_RADIUS] wokół odstępu przed uderzeniem
+    constexpr int64_t LOCAL_RR_RADIUS = 4;
+
+    // Liczba wierszy klasyfikowanych w jednej paczce
+    constexpr size_t BATCH_SIZE = 1024;
+
+    constexpr float NOT_AVAILABLE = std::numeric_limits<float>::quiet_NaN();
+
+    // Węzeł spłaszczonego drzewa decyzyjnego: feature < threshold -> below, w przeciwnym razie above.
+    // Wartość ujemna gałęzi to liść z klasą -(wartość + 1).
+    struct TreeNode {
+        uint8_t feature;
+        float threshold;
+        int8_t below;
+        int8_t above;
+    };
+
+    constexpr int8_t Leaf(BeatClass beat_class) { return static_cast<int8_t>(-1 - static_cast<int>(beat_class)); }
+
+    constexpr TreeNode TREE[] = {
+        // 0: morfologia odbiega od dominującej?
+        {CORRELATION, 0.80f, 1, 3},
+        // 1: inna morfologia - poszerzony QRS oznacza pobudzenie komorowe
+        {QRS_WIDTH_RATIO, 1.25f, 2, Leaf(BeatClass::Ventricular)},
+        // 2: inna morfologia, wąski QRS - komorowe tylko gdy przedwczesne, inaczej zakłócenie
+        {PRE_RR, 0.90f, Leaf(BeatClass::Ventricular), Leaf(BeatClass::Unknown)},
+        // 3: dominująca morfologia - przedwczesne?
+        {PRE_RR, 0.85f, 4, Leaf(BeatClass::Normal)},
+        // 4: przedwczesne o dominującym kształcie: nadkomorowe, chyba że amplituda wyraźnie inna
+        {AMPLITUDE, 1.60f, 5, Leaf(BeatClass::Ventricular)},
+        {AMPLITUDE, 0.50f, Leaf(BeatClass::Ventricular), Leaf(BeatClass::Supraventricular)},
+    };
+
+    BeatClass Classify(const float* row) {
+        for (size_t feature = PRE_RR; feature <= AMPLITUDE; ++feature)
+            if (std::isnan(row[feature])) return BeatClass::Unknown;
+
+        int node = 0;
+        while (node >= 0) {
+            const TreeNode& n = TREE[node];
+            node = row[n.feature] < n.threshold ? n.below : n.above;
+        }
+        return static_cast<BeatClass>(-1 - node);
+    }
+
+    // Zdecymowana morfologia: średnie w przedziałach okna wokół piku R, bez składowej stałej, o normie 1.
+    // Zwraca normę przed normalizacją (amplitudę).
+    float ExtractMorphology(const std::vector<SignalDatapoint>& datapoints, int lead, int64_t r_peak,
+                            int frequency, float* out) {
+        const int64_t last = static_cast<int64_t>(datapoints.size()) - 1;
+        const double from = static_cast<double>(r_peak) - MORPHOLOGY_BEFORE * frequency;
+        const double bin_width = (MORPHOLOGY_BEFORE + MORPHOLOGY_AFTER) * frequency / MORPHOLOGY_POINTS;
+
+        double mean = 0.0;
+        for (size_t b = 0; b < MORPHOLOGY_POINTS; ++b) {
+            const int64_t begin = static_cast<int64_t>(std::lround(from + b * bin_width));
+            const int64_t end = std::max(begin + 1, static_cast<int64_t>(std::lround(from + (b + 1) * bin_width)));
+            double sum = 0.0;
+            for (int64_t k = begin; k < end; ++k)
+                sum += datapoints[std::min(last, std::max<int64_t>(0, k))].channelValues[lead];
+            out[b] = static_cast<float>(sum / static_cast<double>(end - begin));
+            mean += out[b];
+        }
+        mean /= MORPHOLOGY_POINTS;
+
+        double norm = 0.0;
+        for (size_t b = 0; b < MORPHOLOGY_POINTS; ++b) {
+            out[b] = static_cast<float>(out[b] - mean);
+            norm += static_cast<double>(out[b]) * out[b];
+        }
+        norm = std::sqrt(norm);
+        if (norm > 0.0)
+            for (size_t b = 0; b < MORPHOLOGY_POINTS; ++b) out[b] = static_cast<float>(out[b] / norm);
+        return static_cast<float>(norm);
+    }
+
+    // Mediana kolumny macierzy cech po wierszach rows, z pominięciem wartości nieokreślonych
+    float MemberMedian(const FeatureMatrix& features, const std::vector<size_t>& rows, size_t column) {
+        std::vector<float> values;
+        values.reserve(rows.size());
+        for (size_t i : rows) {
+            const float v = features[i * FEATURE_STRIDE + column];
+            if (!std::isnan(v)) values.push_back(v);
+        }
+        if (values.empty()) return NOT_AVAILABLE;
+        auto middle = values.begin() + values.size() / 2;
+        std::nth_element(values.begin(), middle, values.end());
+        return *middle;
+    }
+
+    // Granice ciągłego odcinka [run_begin[i], run_end[i]) każdego uderzenia
+    void RunBounds(size_t n, const std::vector<size_t>& run_starts,
+                   std::vector<size_t>& run_begin, std::vector<size_t>& run_end) {
+        run_begin.resize(n);
+        run_end.resize(n);
+        size_t begin = 0;
+        auto next = run_starts.begin();
+        while (begin < n) {
+            while (next != run_starts.end() && *next <= begin) ++next;
+            const size_t end = next != run_starts.end() ? std::min(*next, n) : n;
+            std::fill(run_begin.begin() + begin, run_begin.begin() + end, begin);
+            std::fill(run_end.begin() + begin, run_end.begin() + end, end);
+            begin = end;
+        }
+    }
+
+    // Podsumowanie rytmu: liczności klas, pary i salwy pobudzeń oraz epizody bigeminii (w obrębie odcinków)
+    void SummarizeRhythm(HeartClassResult& result, const std::vector<size_t>& run_end) {
+        const auto& labels = result.labels;
+        const size_t n = labels.size();
+        for (BeatClass label : labels) ++result.counts[static_cast<size_t>(label)];
+
+        for (size_t i = 0; i < n;) {
+            size_t j = i;
+            while (j < run_end[i] && labels[j] == labels[i]) ++j;
+            const size_t length = j - i;
+            if (labels[i] == BeatClass::Ventricular) {
+                if (length == 2) ++result.ventricular_couplets;
+                else if (length >= 3) ++result.ventricular_runs;
+            } else if (labels[i] == BeatClass::Supraventricular && length >= 3) {
+                ++result.supraventricular_runs;
+            }
+            i = j;
+        }
+
+        auto count_bigeminy = [&](BeatClass ectopic) {
+            size_t episodes = 0;
+            for (size_t i = 0; i + 1 < n;) {
+                size_t cycles = 0;
+                size_t j = i;
+                while (j + 1 < run_end[i] && labels[j] == BeatClass::Normal && labels[j + 1] == ectopic) {
+                    ++cycles;
+                    j += 2;
+                }
+                if (cycles >= 3) ++episodes;
+                i = cycles > 0 ? j : i + 1;
+            }
+            return episodes;
+        };
+        result.ventricular_bigeminy = count_bigeminy(BeatClass::Ventricular);
+        result.supraventricular_bigeminy = count_bigeminy(BeatClass::Supraventricular);
+    }
+}
+
+HeartClassDetectionService::HeartClassDetectionService(int lead) : lead_(lead) {
+}
+
+HeartClassResult HeartClassDetectionService::Detect(const std::vector<SignalDatapoint>& datapoints,
+                                                    const std::vector<BeatFiducials>& beats, int frequency,
+                                                    const std::vector<size_t>& run_starts) {
+    HeartClassResult result;
+    const size_t n = beats.size();
+    if (n == 0 || datapoints.empty() || frequency <= 0) return result;
+
+    // Odstępy RR [próbki]; odstęp i leży między uderzeniami i oraz i + 1. Odstęp między odcinkami
+    // (przez odrzucony fragment sygnału) nie trafia do cech ani do lokalnej mediany.
+    std::vector<double> rr(n > 1 ? n - 1 : 0);
+    for (size_t i = 0; i + 1 < n; ++i)
+        rr[i] = static_cast<double>(beats[i + 1].r_peak - beats[i].r_peak);
+    std::vector<size_t> run_begin, run_end;
+    RunBounds(n, run_starts, run_begin, run_end);
+
+    FeatureMatrix features(n * FEATURE_STRIDE, 0.0f);
+
+    // Przebieg 1: cechy rytmu, szerokość QRS i morfologia każdego uderzenia
+    ParallelForRange(n, BATCH_SIZE, [&](size_t from, size_t to) {
+        double window[2 * LOCAL_RR_RADIUS + 1];
+        for (size_t i = from; i < to; ++i) {
+            float* row = &features[i * FEATURE_STRIDE];
+            const BeatFiducials& beat = beats[i];
+
+            row[PRE_RR] = row[POST_RR] = NOT_AVAILABLE;
+            if (i > run_begin[i] && i + 1 < run_end[i]) {
+                const int64_t center = static_cast<int64_t>(i) - 1;
+                const int64_t first = std::max<int64_t>(static_cast<int64_t>(run_begin[i]), center - LOCAL_RR_RADIUS);
+                const int64_t last = std::min<int64_t>(static_cast<int64_t>(run_end[i]) - 2, center + LOCAL_RR_RADIUS);
+                const size_t count = static_cast<size_t>(last - first + 1);
+                std::copy(rr.begin() + first, rr.begin() + last + 1, window);
+                std::nth_element(window, window + count / 2, window + count);
+                const double local_rr = window[count / 2];
+                if (local_rr > 0.0) {
+                    row[PRE_RR] = static_cast<float>(rr[i - 1] / local_rr);
+                    row[POST_RR] = static_cast<float>(rr[i] / local_rr);
+                }
+            }
+
+            row[QRS_WIDTH] = beat.qrs_onset != BeatFiducials::NONE && beat.qrs_offset != BeatFiducials::NONE
+                                 ? static_cast<float>(1000.0 * (beat.qrs_offset - beat.qrs_onset) / frequency)
+                                 : NOT_AVAILABLE;
+            row[AMPLITUDE] = ExtractMorphology(datapoints, lead_, beat.r_peak, frequency, row + MORPHOLOGY);
+        }
+    });
+
+    // Grupowanie morfologii: uderzenia trafiają kolejno do grup o korelacji z wzorcem >= CLUSTER_CORRELATION.
+    // Porównanie z dominującą morfologią liczone jest raz na grupę, a nie dla każdego uderzenia.
+    BeatClusterer clusterer(MORPHOLOGY_POINTS, CLUSTER_CORRELATION, MAX_CLUSTERS);
+    for (size_t i = 0; i < n; ++i)
+        clusterer.Add(&features[i * FEATURE_STRIDE + MORPHOLOGY]);
+    result.clusters = clusterer.Clusters();
+
+    std::vector<size_t> cluster_of(n);
+    for (size_t c = 0; c < result.clusters.size(); ++c)
+        for (size_t member : result.clusters[c].members) cluster_of[member] = c;
+
+    const BeatCluster& dominant = result.clusters.front();
+    std::vector<float> cluster_correlation(result.clusters.size());
+    for (size_t c = 0; c < result.clusters.size(); ++c) {
+        float correlation = 0.0f;
+        for (size_t b = 0; b < MORPHOLOGY_POINTS; ++b)
+            correlation += result.clusters[c].morphology[b] * dominant.morphology[b];
+        cluster_correlation[c] = correlation;
+    }
+    const float dominant_amplitude = MemberMedian(features, dominant.members, AMPLITUDE);
+    const float dominant_width = MemberMedian(features, dominant.members, QRS_WIDTH);
+
+    // Przebieg 2: cechy względem dominującej grupy i klasyfikacja paczkami wierszy
+    result.labels.resize(n);
+    ParallelForRange(n, BATCH_SIZE, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            float* row = &features[i * FEATURE_STRIDE];
+            row[CORRELATION] = cluster_correlation[cluster_of[i]];
+            row[AMPLITUDE] = dominant_amplitude > 0.0f ? row[AMPLITUDE] / dominant_amplitude : NOT_AVAILABLE;
+            row[QRS_WIDTH_RATIO] = dominant_width > 0.0f ? row[QRS_WIDTH] / dominant_width : NOT_AVAILABLE;
+        }
+        for (size_t i = from; i < to; ++i)
+            result.labels[i] = Classify(&features[i * FEATURE_STRIDE]);
+    });
+
+    // Etykieta grupy - klasa przeważająca wśród jej sklasyfikowanych członków
+    for (BeatCluster& cluster : result.clusters) {
+        size_t votes[HeartClassResult::CLASS_COUNT] = {0, 0, 0, 0};
+        for (size_t member : cluster.members) ++votes[static_cast<size_t>(result.labels[member])];
+        votes[static_cast<size_t>(BeatClass::Unknown)] = 0;
+        const size_t best = std::max_element(votes, votes + HeartClassResult::CLASS_COUNT) - votes;
+        cluster.label = votes[best] > 0 ? static_cast<BeatClass>(best) : BeatClass::Unknown;
+    }
+
+    SummarizeRhythm(result, run_end);
+    return result;
 }
@@ -1,6 +1,148 @@
 #include "../../include/service/hrv_dfa_processing_service.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <vector>
 
-HRVDFAMetrics HRVDFAProcessingService::Process(const std::vector<SignalDatapoint> &datapoints, int frequency) {
-    // TODO(Hubert): trzeba uzupełnić
-    return HRVDFAMetrics{};
+#include "../../include/util/parallel_for.h"
+
+namespace {
+    // Zakresy skal (długości okien w uderzeniach) dla wykładnika krótko- i długoterminowego
+    constexpr int ALPHA1_MIN_SCALE = 4;
+    constexpr int ALPHA1_MAX_SCALE = 16;
+    constexpr int ALPHA2_MIN_SCALE = 16;
+    constexpr int ALPHA2_MAX_SCALE = 64;
+
+    // Długość bloku sum prefiksowych - nie mniejsza od największej skali, więc okno leży w co najwyżej dwóch blokach
+    constexpr size_t SUM_BLOCK = ALPHA2_MAX_SCALE;
+
+    // Sumy prefiksowe profilu: y, t * y oraz y^2, liczone od początku każdego bloku SUM_BLOCK próbek,
+    // z profilem i czasem t mierzonymi względem początku bloku. Dla okna [a, a + n) reszta dopasowania
+    // prostej metodą najmniejszych kwadratów wynika wprost z różnic sum, więc kosztuje O(1) niezależnie od n.
+    // Sumy w obrębie bloku pozostają małe także dla długich lub dryfujących serii, więc odejmowanie
+    // w Residual nie traci dokładności (sumy globalne rosną jak N^2 i przy 1e5 uderzeń znoszą się do zera).
+    struct ProfileSums {
+        std::vector<double> y, ty, yy;   // sumy od początku bloku do próbki włącznie
+        std::vector<double> block_step;  // przyrost profilu od początku bloku k do początku bloku k + 1
+
+        explicit ProfileSums(const std::vector<double>& intervals) {
+            const size_t n = intervals.size();
+            const double mean = std::accumulate(intervals.begin(), intervals.end(), 0.0) / n;
+            y.assign(n, 0.0);
+            ty.assign(n, 0.0);
+            yy.assign(n, 0.0);
+            block_step.assign(n / SUM_BLOCK + 1, 0.0);
+
+            double profile = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                const size_t t = i % SUM_BLOCK;
+                if (t == 0 && i > 0) {
+                    block_step[i / SUM_BLOCK - 1] = profile + (intervals[i] - mean);
+                    profile = 0.0;
+                } else if (i > 0) {
+                    profile += intervals[i] - mean;
+                }
+                y[i] = (t ? y[i - 1] : 0.0) + profile;
+                ty[i] = (t ? ty[i - 1] : 0.0) + static_cast<double>(t) * profile;
+                yy[i] = (t ? yy[i - 1] : 0.0) + profile * profile;
+            }
+        }
+
+        // Sumy y, t * y, y^2 próbek [from, to) jednego bloku, z t i y względem początku bloku
+        void BlockSums(size_t from, size_t to, double& sy, double& sty, double& syy) const {
+            const bool first = from % SUM_BLOCK == 0;
+            sy = y[to - 1] - (first ? 0.0 : y[from - 1]);
+            sty = ty[to - 1] - (first ? 0.0 : ty[from - 1]);
+            syy = yy[to - 1] - (first ? 0.0 : yy[from - 1]);
+        }
+
+        // Suma kwadratów reszt po usunięciu trendu liniowego w oknie [a, a + n)
+        double Residual(size_t a, size_t n) const {
+            // Część okna w bloku a, przeniesiona na czas lokalny okna t = i - a
+            const size_t block_start = a - a % SUM_BLOCK;
+            const size_t split = std::min(a + n, block_start + SUM_BLOCK);
+            double sy, sty, syy;
+            BlockSums(a, split, sy, sty, syy);
+            sty -= static_cast<double>(a - block_start) * sy;
+
+            // Reszta okna w następnym bloku: profil przesunięty o przyrost bloku, czas o split - a
+            if (split < a + n) {
+                const double m = static_cast<double>(a + n - split);
+                const double shift = block_step[block_start / SUM_BLOCK];
+                const double offset = static_cast<double>(split - a);
+                double ny, nty, nyy;
+                BlockSums(split, a + n, ny, nty, nyy);
+                const double st = m * (m - 1.0) / 2.0;
+                sty += nty + shift * st + offset * ny + offset * m * shift;
+                syy += nyy + 2.0 * shift * ny + m * shift * shift;
+                sy += ny + m * shift;
+            }
+
+            const double len = static_cast<double>(n);
+            const double st = len * (len - 1.0) / 2.0;
+            const double stt = (len - 1.0) * len * (2.0 * len - 1.0) / 6.0;
+
+            const double sxx = stt - st * st / len;
+            const double sxy = sty - st * sy / len;
+            const double syy_centered = syy - sy * sy / len;
+            const double residual = syy_centered - sxy * sxy / sxx;
+            return residual > 0.0 ? residual : 0.0;
+        }
+    };
+
+    // Funkcja fluktuacji F(n): okna bez nakładania liczone od początku i od końca serii
+    double Fluctuation(const ProfileSums& sums, size_t length, size_t scale) {
+        const size_t boxes = length / scale;
+        if (boxes == 0) return 0.0;
+        const size_t tail = length - boxes * scale;
+
+        double total = 0.0;
+        for (size_t b = 0; b < boxes; ++b) {
+            total += sums.Residual(b * scale, scale);
+            total += sums.Residual(tail + b * scale, scale);
+        }
+        return std::sqrt(total / (2.0 * boxes * scale));
+    }
+
+    // Nachylenie prostej log F(n) względem log n w zakresie skal [from, to]
+    float ScalingExponent(const std::vector<double>& fluctuations, int from, int to) {
+        double sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0;
+        int count = 0;
+        for (int scale = from; scale <= to; ++scale) {
+            const double f = fluctuations[scale];
+            if (f <= 0.0) continue;
+            const double x = std::log(static_cast<double>(scale));
+            const double y = std::log(f);
+            sx += x;
+            sy += y;
+            sxx += x * x;
+            sxy += x * y;
+            ++count;
+        }
+        if (count < 2) return 0.0f;
+        const double denominator = count * sxx - sx * sx;
+        return denominator > 0.0 ? static_cast<float>((count * sxy - sx * sy) / denominator) : 0.0f;
+    }
+}
+
+HRVDFAMetrics HRVDFAProcessingService::Process(const RRSeries &rr_series) {
+    HRVDFAMetrics metrics{0.0f, 0.0f};
+
+    const std::vector<double> &intervals = rr_series.nn_intervals;
+    const size_t length = intervals.size();
+    if (length < 2 * ALPHA1_MIN_SCALE) return metrics;
+
+    // Profil budowany raz, skale liczone równolegle - każda w czasie O(N / n) okien po O(1)
+    const ProfileSums sums(intervals);
+    const int max_scale = static_cast<int>(std::min<size_t>(ALPHA2_MAX_SCALE, length / 2));
+    std::vector<double> fluctuations(ALPHA2_MAX_SCALE + 1, 0.0);
+    ParallelFor(static_cast<size_t>(max_scale - ALPHA1_MIN_SCALE + 1), [&](size_t i) {
+        const size_t scale = ALPHA1_MIN_SCALE + i;
+        fluctuations[scale] = Fluctuation(sums, length, scale);
+    }, 8);
+
+    metrics.alpha1 = ScalingExponent(fluctuations, ALPHA1_MIN_SCALE, std::min(ALPHA1_MAX_SCALE, max_scale));
+    if (max_scale > ALPHA2_MIN_SCALE)
+        metrics.alpha2 = ScalingExponent(fluctuations, ALPHA2_MIN_SCALE, max_scale);
+    return metrics;
 }
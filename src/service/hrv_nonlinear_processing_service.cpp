@@ -0,0 +1,188 @@
+#include "../../include/service/hrv_nonlinear_processing_service.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <vector>
+
+#include "../../include/util/parallel_for.h"
+
+namespace {
+    // Liczba wzorców przetwarzanych w jednym fragmencie przy równoległym liczeniu dopasowań
+    constexpr size_t TEMPLATES_PER_CHUNK = 1024;
+
+    // Siatka kubełków o boku r na dwóch pierwszych współrzędnych wzorca. Wzorce pasujące do danego
+    // (odległość Czebyszewa <= r) mogą leżeć tylko w sąsiednich kubełkach, więc zamiast porównywać
+    // każdą parę wystarczy przejrzeć 3 x 3 kubełki. Kubełki są posortowane po kluczu, a kubełki
+    // o tym samym x i kolejnych y tworzą ciągły fragment tablicy.
+    class TemplateGrid {
+        std::vector<int64_t> keys_;   // klucze posortowane rosnąco
+        std::vector<uint32_t> order_; // indeksy wzorców w kolejności kluczy
+        std::vector<int64_t> cell_x_, cell_y_;
+        int64_t rows_ = 1;
+
+    public:
+        TemplateGrid(const std::vector<double>& x, size_t templates, int m, double r) {
+            const double lo = *std::min_element(x.begin(), x.end());
+            const double hi = *std::max_element(x.begin(), x.end());
+            rows_ = m > 1 ? static_cast<int64_t>(std::floor((hi - lo) / r)) + 1 : 1;
+
+            cell_x_.resize(templates);
+            cell_y_.resize(templates);
+            std::vector<std::pair<int64_t, uint32_t>> entries(templates);
+            for (size_t i = 0; i < templates; ++i) {
+                cell_x_[i] = static_cast<int64_t>(std::floor((x[i] - lo) / r));
+                cell_y_[i] = m > 1 ? static_cast<int64_t>(std::floor((x[i + 1] - lo) / r)) : 0;
+                entries[i] = {cell_x_[i] * rows_ + cell_y_[i], static_cast<uint32_t>(i)};
+            }
+            std::sort(entries.begin(), entries.end());
+
+            keys_.resize(templates);
+            order_.resize(templates);
+            for (size_t i = 0; i < templates; ++i) {
+                keys_[i] = entries[i].first;
+                order_[i] = entries[i].second;
+            }
+        }
+
+        // Wywołuje visit(j) dla każdego wzorca z kubełków sąsiadujących z kubełkiem wzorca i (łącznie z i)
+        template<typename Visit>
+        void ForEachCandidate(size_t i, Visit&& visit) const {
+            const int64_t y_from = std::max<int64_t>(0, cell_y_[i] - 1);
+            const int64_t y_to = std::min<int64_t>(rows_ - 1, cell_y_[i] + 1);
+            for (int64_t dx = -1; dx <= 1; ++dx) {
+                const int64_t cx = cell_x_[i] + dx;
+                if (cx < 0) continue;
+                auto first = std::lower_bound(keys_.begin(), keys_.end(), cx * rows_ + y_from);
+                auto last = std::upper_bound(first, keys_.end(), cx * rows_ + y_to);
+                for (auto it = first; it != last; ++it)
+                    visit(order_[it - keys_.begin()]);
+            }
+        }
+    };
+
+    struct EntropyCounts {
+        // Entropia próbkowa: liczba par dopasowanych na długości m (B) i m + 1 (A), bez samodopasowań
+        long long matches_m = 0;
+        long long matches_m1 = 0;
+        // Entropia przybliżona: sumy log(C_i / liczba wzorców) dla długości m i m + 1
+        double phi_m = 0.0;
+        double phi_m1 = 0.0;
+    };
+
+    // Zlicza dopasowania wzorców długości m i m + 1 w jednym przebiegu po siatce.
+    // parallel - czy dzielić wzorce między wątki (wyłączone, gdy równolegle liczone są skale)
+    EntropyCounts CountMatches(const std::vector<double>& x, int m, double r, bool approximate, bool parallel) {
+        EntropyCounts counts;
+        const size_t n = x.size();
+        if (n <= static_cast<size_t>(m) + 1 || r <= 0.0) return counts;
+
+        // N - m + 1 wzorców długości m; wzorce długości m + 1 (i przy entropii próbkowej także
+        // wzorce długości m) mają indeksy < N - m
+        const size_t templates = n - m + 1;
+        const size_t extended = n - m;
+        const TemplateGrid grid(x, templates, m, r);
+
+        const size_t chunks = (templates + TEMPLATES_PER_CHUNK - 1) / TEMPLATES_PER_CHUNK;
+        std::vector<EntropyCounts> partial(chunks);
+        auto count_range = [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) {
+                EntropyCounts& local = partial[i / TEMPLATES_PER_CHUNK];
+                long long c_m = 0, c_m1 = 0, b = 0, a = 0;
+                grid.ForEachCandidate(i, [&](size_t j) {
+                    for (int k = 0; k < m; ++k) {
+                        if (std::fabs(x[i + k] - x[j + k]) > r) return;
+                    }
+                    ++c_m;
+                    const bool both_extended = i < extended && j < extended;
+                    const bool match_m1 = both_extended && std::fabs(x[i + m] - x[j + m]) <= r;
+                    if (match_m1) ++c_m1;
+                    if (both_extended && j != i) {
+                        ++b;
+                        if (match_m1) ++a;
+                    }
+                });
+                local.matches_m += b;
+                local.matches_m1 += a;
+                if (approximate) {
+                    local.phi_m += std::log(static_cast<double>(c_m) / templates);
+                    if (i < extended) local.phi_m1 += std::log(static_cast<double>(c_m1) / extended);
+                }
+            }
+        };
+
+        if (parallel) {
+            ParallelForRange(templates, TEMPLATES_PER_CHUNK, count_range);
+        } else {
+            count_range(0, templates);
+        }
+
+        // Sumy częściowe łączone w stałej kolejności
+        for (const EntropyCounts& local : partial) {
+            counts.matches_m += local.matches_m;
+            counts.matches_m1 += local.matches_m1;
+            counts.phi_m += local.phi_m;
+            counts.phi_m1 += local.phi_m1;
+        }
+        counts.phi_m /= templates;
+        counts.phi_m1 /= extended;
+        return counts;
+    }
+
+    double SampleEntropy(const EntropyCounts& counts) {
+        if (counts.matches_m == 0 || counts.matches_m1 == 0) return -1.0;
+        return -std::log(static_cast<double>(counts.matches_m1) / counts.matches_m);
+    }
+
+    double StandardDeviation(const std::vector<double>& x) {
+        const double mean = std::accumulate(x.begin(), x.end(), 0.0) / x.size();
+        double variance = 0.0;
+        for (double v : x) variance += (v - mean) * (v - mean);
+        return std::sqrt(variance / x.size());
+    }
+
+    // Seria uśredniona w nienakładających się oknach o długości scale
+    std::vector<double> CoarseGrain(const std::vector<double>& x, int scale) {
+        std::vector<double> result(x.size() / scale);
+        for (size_t i = 0; i < result.size(); ++i) {
+            double sum = 0.0;
+            for (int k = 0; k < scale; ++k) sum += x[i * scale + k];
+            result[i] = sum / scale;
+        }
+        return result;
+    }
+}
+
+HRVNonlinearProcessingService::HRVNonlinearProcessingService(int embedding_dimension, double tolerance, int max_scale)
+    : embedding_dimension_(embedding_dimension), tolerance_(tolerance), max_scale_(max_scale) {
+}
+
+HRVNonlinearMetrics HRVNonlinearProcessingService::Process(const RRSeries &rr_series) {
+    HRVNonlinearMetrics metrics;
+
+    const std::vector<double> &intervals = rr_series.nn_intervals;
+    if (embedding_dimension_ < 1 || intervals.size() <= static_cast<size_t>(embedding_dimension_) + 1)
+        return metrics;
+
+    // Tolerancja r wyznaczona z serii pierwotnej i wspólna dla wszystkich skal
+    const double r = tolerance_ * StandardDeviation(intervals);
+    if (r <= 0.0) return metrics;
+
+    const EntropyCounts counts = CountMatches(intervals, embedding_dimension_, r, true, true);
+    metrics.sample_entropy = SampleEntropy(counts);
+    metrics.approximate_entropy = counts.phi_m - counts.phi_m1;
+
+    // Skale entropii wieloskalowej są niezależne - liczone równolegle, każda w jednym wątku
+    if (max_scale_ >= 1) {
+        metrics.multiscale_entropy.assign(max_scale_, -1.0);
+        metrics.multiscale_entropy[0] = metrics.sample_entropy;
+        ParallelFor(static_cast<size_t>(max_scale_ - 1), [&](size_t i) {
+            const int scale = static_cast<int>(i) + 2;
+            const std::vector<double> coarse = CoarseGrain(intervals, scale);
+            metrics.multiscale_entropy[scale - 1] =
+                    SampleEntropy(CountMatches(coarse, embedding_dimension_, r, false, false));
+        });
+    }
+
+    return metrics;
+}
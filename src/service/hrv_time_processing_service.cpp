@@ -1,4 +1,8 @@
 #include "../../include/service/hrv_time_processing_service.h"
+#include "../../include/dsp/fft.h"
+#include "../../include/dsp/spectral_window.h"
+#include "../../include/dsp/welch_estimator.h"
+#include "../../include/util/parallel_for.h"
 #include <cmath>
 #include <vector>
 #include <algorithm>
@@ -9,38 +13,11 @@
 #define M_PI 3.14159265358979323846
 #endif
 
-// Pomocnicza funkcja do ekstrakcji odstępów RR z wykrytych pików R
-std::vector<double> ExtractRRIntervals(
-    const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks,
-    int frequency) {
-    std::vector<double> rr_intervals;
-    
-    if (r_peaks.empty()) {
-        return rr_intervals;
-    }
-    
-    // Znajdź wszystkie indeksy, gdzie peak == true
-    std::vector<size_t> peak_indices;
-    for (size_t i = 0; i < r_peaks.size(); ++i) {
-        if (r_peaks[i].peak) {
-            peak_indices.push_back(i);
-        }
-    }
-    
-    // Oblicz odstępy RR w milisekundach
-    for (size_t i = 1; i < peak_indices.size(); ++i) {
-        double interval_ms = (peak_indices[i] - peak_indices[i - 1]) * 1000.0 / frequency;
-        if (interval_ms > 300.0 && interval_ms < 2000.0) { // Filtrowanie artefaktów
-            rr_intervals.push_back(interval_ms);
-        }
-    }
-    
-    return rr_intervals;
-}
-
 // Oblicz parametry czasowe HRV
+// successive[i] - czy odstęp i bezpośrednio następuje po odstępie i - 1 (bez artefaktu pomiędzy)
 void CalculateTimeDomainMetrics(
     const std::vector<double>& rr_intervals,
+    const std::vector<bool>& successive,
     HRVTimeMetrics& metrics) {
     
     if (rr_intervals.empty()) {
@@ -64,217 +41,244 @@ void CalculateTimeDomainMetrics(
     metrics.sdnn = static_cast<float>(std::sqrt(variance));
     
     // RMSSD - pierwiastek ze średniej kwadratów różnic między kolejnymi odstępami RR
-    if (rr_intervals.size() > 1) {
-        double sum_squared_diff = 0.0;
-        for (size_t i = 1; i < rr_intervals.size(); ++i) {
-            double diff = rr_intervals[i] - rr_intervals[i - 1];
-            sum_squared_diff += diff * diff;
-        }
-        metrics.rmssd = static_cast<float>(std::sqrt(sum_squared_diff / (rr_intervals.size() - 1)));
+    double sum_squared_diff = 0.0;
+    size_t diff_count = 0;
+    for (size_t i = 1; i < rr_intervals.size(); ++i) {
+        if (!successive[i]) continue;
+        double diff = rr_intervals[i] - rr_intervals[i - 1];
+        sum_squared_diff += diff * diff;
+        ++diff_count;
+    }
+    if (diff_count > 0) {
+        metrics.rmssd = static_cast<float>(std::sqrt(sum_squared_diff / diff_count));
     } else {
         metrics.rmssd = 0.0f;
     }
 }
 
-// Interpolacja sygnału RR do równomiernego próbkowania
-std::vector<double> InterpolateRRSignal(
-    const std::vector<double>& rr_intervals,
-    double target_sampling_rate = 4.0) { // 4 Hz - standardowa częstotliwość dla HRV
-    
-    if (rr_intervals.empty()) {
-        return std::vector<double>();
-    }
-    
-    // Oblicz skumulowane czasy dla każdego odstępu RR
-    std::vector<double> cumulative_times;
-    cumulative_times.push_back(0.0);
-    for (size_t i = 0; i < rr_intervals.size(); ++i) {
-        cumulative_times.push_back(cumulative_times.back() + rr_intervals[i]);
-    }
-    
-    // Interpolacja liniowa
-    double total_time = cumulative_times.back();
-    size_t num_samples = static_cast<size_t>(total_time * target_sampling_rate / 1000.0);
-    
-    std::vector<double> interpolated(num_samples);
-    double dt = 1000.0 / target_sampling_rate; // krok czasowy w ms
-    
-    for (size_t i = 0; i < num_samples; ++i) {
-        double t = i * dt;
-        
-        size_t interval_idx = 0;
-        for (size_t j = 0; j < cumulative_times.size() - 1; ++j) {
-            if (t >= cumulative_times[j] && t < cumulative_times[j + 1]) {
-                interval_idx = j;
-                break;
-            }
-        }
-        
-        if (interval_idx < rr_intervals.size()) {
-            interpolated[i] = rr_intervals[interval_idx];
-        } else {
-            interpolated[i] = rr_intervals.back();
-        }
-    }
-    
-    return interpolated;
-}
-
 // Klasyczny periodogram (FFT)
-std::vector<double> ClassicPeriodogram(const std::vector<double>& signal, double sampling_rate) {
+// Sygnał jest uzupełniany zerami do najbliższej szybkiej długości transformaty, frequencies
+// otrzymuje częstotliwości kolejnych prążków (k * fs / nfft). Uzupełnienie zerami zagęszcza prążki
+// (df = fs / nfft), a suma |X|^2 rośnie proporcjonalnie do nfft, więc przy normalizacji przez N * N
+// suma mocy razy rozdzielczość nie zależy od uzupełnienia.
+std::vector<double> ClassicPeriodogram(
+    const std::vector<double>& signal,
+    double sampling_rate,
+    std::vector<double>& frequencies) {
     size_t N = signal.size();
+    frequencies.clear();
     if (N == 0) {
         return std::vector<double>();
     }
     
-    // Oblicz średnią i usuń składową stałą
+    // Oblicz średnią i usuń składową stałą, reszta bufora to zera
+    size_t fft_size = RealFFT::NextFastSize(N);
     double mean = std::accumulate(signal.begin(), signal.end(), 0.0) / N;
-    std::vector<double> centered_signal(N);
+    std::vector<double> centered_signal(fft_size, 0.0);
     for (size_t i = 0; i < N; ++i) {
         centered_signal[i] = signal[i] - mean;
     }
     
-    // Prosta implementacja DFT (dla małych sygnałów)
-    // Dla większych sygnałów warto użyć FFT (np. FFTW)
-    size_t fft_size = N;
-    std::vector<double> power_spectrum(fft_size / 2 + 1);
+    auto fft = RealFFT::ForSize(fft_size);
+    std::vector<std::complex<double>> spectrum(fft->SpectrumSize());
+    fft->Forward(centered_signal.data(), spectrum.data());
     
-    for (size_t k = 0; k <= fft_size / 2; ++k) {
-        std::complex<double> sum(0.0, 0.0);
-        for (size_t n = 0; n < N; ++n) {
-            double angle = -2.0 * M_PI * k * n / fft_size;
-            sum += centered_signal[n] * std::complex<double>(std::cos(angle), std::sin(angle));
-        }
-        power_spectrum[k] = std::norm(sum) / (N * N);
+    std::vector<double> power_spectrum(spectrum.size());
+    frequencies.resize(spectrum.size());
+    const double normalization = static_cast<double>(N) * N;
+    for (size_t k = 0; k < spectrum.size(); ++k) {
+        power_spectrum[k] = std::norm(spectrum[k]) / normalization;
+        frequencies[k] = k * sampling_rate / fft_size;
     }
     
     return power_spectrum;
 }
 
-// Periodogram Lomb-Scargle
+// Moc Lomb-Scargle z sum trygonometrycznych dla jednej częstotliwości
+// c, s - sumy (y - średnia) * cos(wt), (y - średnia) * sin(wt); c2, s2 - sumy cos(2wt), sin(2wt).
+// Przesunięcie fazowe tau wynika z c2 i s2 (tg(2wtau) = s2 / c2), więc nie wymaga osobnego przebiegu.
+double LombScarglePower(double c, double s, double c2, double s2, double n, double variance) {
+    double hypo = std::sqrt(c2 * c2 + s2 * s2);
+    double cos_2tau = hypo > 1e-12 ? c2 / hypo : 1.0;
+    double sin_2tau = hypo > 1e-12 ? s2 / hypo : 0.0;
+    double cos_tau = std::sqrt(0.5 * (1.0 + cos_2tau));
+    double sin_tau = (sin_2tau < 0.0 ? -1.0 : 1.0) * std::sqrt(std::max(0.0, 0.5 * (1.0 - cos_2tau)));
+    
+    // Suma cos^2(w(t - tau)) oraz sin^2(w(t - tau))
+    double cos_norm = 0.5 * (n + hypo);
+    double sin_norm = n - cos_norm;
+    
+    double cos_val = c * cos_tau + s * sin_tau;
+    double sin_val = s * cos_tau - c * sin_tau;
+    double power = 0.0;
+    if (cos_norm > 1e-12) power += cos_val * cos_val / cos_norm;
+    if (sin_norm > 1e-12) power += sin_val * sin_val / sin_norm;
+    return power / (2.0 * variance);
+}
+
+// Periodogram Lomb-Scargle liczony wprost na siatce f_k = (first + k) * df, k = 0..count-1
+// Sinusy i cosinusy kolejnych częstotliwości powstają z obrotu poprzednich (rekurencja), więc funkcje
+// trygonometryczne liczone są tylko raz na próbkę, a nie dla każdej pary (próbka, częstotliwość).
 std::vector<double> LombScarglePeriodogram(
     const std::vector<double>& signal,
     const std::vector<double>& times,
-    const std::vector<double>& frequencies) {
+    size_t first,
+    size_t count,
+    double df) {
     
-    if (signal.size() != times.size() || signal.empty()) {
+    if (signal.size() != times.size() || signal.empty() || count == 0) {
         return std::vector<double>();
     }
     
-    std::vector<double> power_spectrum(frequencies.size());
-    
-    // Oblicz średnią i wariancję
-    double mean = std::accumulate(signal.begin(), signal.end(), 0.0) / signal.size();
+    const size_t n = signal.size();
+    double mean = std::accumulate(signal.begin(), signal.end(), 0.0) / n;
     double variance = 0.0;
     for (double val : signal) {
         double diff = val - mean;
         variance += diff * diff;
     }
-    variance /= signal.size();
+    variance /= n;
     
     if (variance < 1e-10) {
-        return std::vector<double>(frequencies.size(), 0.0);
+        return std::vector<double>(count, 0.0);
     }
     
-    for (size_t i = 0; i < frequencies.size(); ++i) {
-        double omega = 2.0 * M_PI * frequencies[i];
-        
-        // Oblicz tau (optymalne przesunięcie fazowe)
-        double sin_sum = 0.0, cos_sum = 0.0;
-        for (size_t j = 0; j < times.size(); ++j) {
-            double angle = omega * times[j];
-            sin_sum += std::sin(2.0 * angle);
-            cos_sum += std::cos(2.0 * angle);
-        }
-        double tau = std::atan2(sin_sum, cos_sum) / (2.0 * omega);
-        
-        // Oblicz periodogram
-        double cos_sum_val = 0.0, sin_sum_val = 0.0;
-        double cos_norm = 0.0, sin_norm = 0.0;
-        
-        for (size_t j = 0; j < times.size(); ++j) {
-            double angle = omega * (times[j] - tau);
-            double cos_val = std::cos(angle);
-            double sin_val = std::sin(angle);
-            double centered_val = signal[j] - mean;
+    // Stan rekurencji dla każdej próbki: cos/sin bieżącego kąta i obrót o krok siatki
+    std::vector<double> centered(n), cos_wt(n), sin_wt(n), cos_step(n), sin_step(n);
+    for (size_t j = 0; j < n; ++j) {
+        double t = times[j] - times[0];
+        double angle = 2.0 * M_PI * first * df * t;
+        double step = 2.0 * M_PI * df * t;
+        centered[j] = signal[j] - mean;
+        cos_wt[j] = std::cos(angle);
+        sin_wt[j] = std::sin(angle);
+        cos_step[j] = std::cos(step);
+        sin_step[j] = std::sin(step);
+    }
+    
+    std::vector<double> power_spectrum(count);
+    for (size_t k = 0; k < count; ++k) {
+        double c = 0.0, s = 0.0, c2 = 0.0, s2 = 0.0;
+        for (size_t j = 0; j < n; ++j) {
+            double cw = cos_wt[j];
+            double sw = sin_wt[j];
+            c += centered[j] * cw;
+            s += centered[j] * sw;
+            c2 += (cw - sw) * (cw + sw);
+            s2 += 2.0 * sw * cw;
             
-            cos_sum_val += centered_val * cos_val;
-            sin_sum_val += centered_val * sin_val;
-            cos_norm += cos_val * cos_val;
-            sin_norm += sin_val * sin_val;
+            cos_wt[j] = cw * cos_step[j] - sw * sin_step[j];
+            sin_wt[j] = sw * cos_step[j] + cw * sin_step[j];
         }
-        
-        double power = (cos_sum_val * cos_sum_val / cos_norm + 
-                       sin_sum_val * sin_sum_val / sin_norm) / (2.0 * variance);
-        power_spectrum[i] = power;
+        power_spectrum[k] = LombScarglePower(c, s, c2, s2, static_cast<double>(n), variance);
     }
     
     return power_spectrum;
 }
 
-// Periodogram Welch (z oknem i nakładaniem)
-std::vector<double> WelchPeriodogram(
+// Rozrzuca wartość y z niecałkowitej pozycji x na order sąsiednich węzłów siatki okresowej
+// (odwrotność interpolacji Lagrange'a, "extirpolation" wg Press i Rybicki)
+void Extirpolate(double y, double x, std::vector<double>& grid, int order) {
+    const long long n = static_cast<long long>(grid.size());
+    long long ix = static_cast<long long>(std::floor(x));
+    if (x == static_cast<double>(ix)) {
+        grid[((ix % n) + n) % n] += y;
+        return;
+    }
+    
+    long long lo = ix - order / 2 + 1;
+    for (int i = 0; i < order; ++i) {
+        double weight = 1.0;
+        for (int j = 0; j < order; ++j) {
+            if (j != i) weight *= (x - static_cast<double>(lo + j)) / static_cast<double>(i - j);
+        }
+        grid[(((lo + i) % n) + n) % n] += y * weight;
+    }
+}
+
+// Szybki periodogram Lomb-Scargle (Press i Rybicki, 1989) na siatce f_k = (first + k) * df
+// Próbki są rozrzucane na równomierną siatkę czasu, a sumy trygonometryczne dla wszystkich
+// częstotliwości naraz daje jedna transformata FFT - koszt O(N + M log M) zamiast O(N * M).
+std::vector<double> FastLombScarglePeriodogram(
     const std::vector<double>& signal,
-    double sampling_rate,
-    size_t window_size = 256,
-    double overlap = 0.5) {
+    const std::vector<double>& times,
+    size_t first,
+    size_t count,
+    double df,
+    int order) {
     
-    if (signal.empty()) {
+    if (signal.size() != times.size() || signal.empty() || count == 0) {
         return std::vector<double>();
     }
     
-    size_t N = signal.size();
-    size_t step = static_cast<size_t>(window_size * (1.0 - overlap));
-    size_t num_segments = (N - window_size) / step + 1;
+    const size_t n = signal.size();
+    double mean = std::accumulate(signal.begin(), signal.end(), 0.0) / n;
+    double variance = 0.0;
+    for (double val : signal) {
+        double diff = val - mean;
+        variance += diff * diff;
+    }
+    variance /= n;
     
-    if (num_segments == 0) {
-        return ClassicPeriodogram(signal, sampling_rate);
+    if (variance < 1e-10) {
+        return std::vector<double>(count, 0.0);
     }
     
-    // Oblicz średnią i usuń składową stałą
-    double mean = std::accumulate(signal.begin(), signal.end(), 0.0) / N;
-    std::vector<double> centered_signal(N);
-    for (size_t i = 0; i < N; ++i) {
-        centered_signal[i] = signal[i] - mean;
+    // Najwyższy potrzebny prążek to 2 * (first + count) (sumy dla podwójnej częstotliwości),
+    // siatka jest kilkukrotnie gęstsza, żeby interpolacja była dokładna
+    const size_t last = first + count;
+    const size_t fft_size = RealFFT::NextFastSize(4 * std::max(order, 2) * last);
+    const double scale = df * fft_size;
+    
+    std::vector<double> data_grid(fft_size, 0.0);
+    std::vector<double> unit_grid(fft_size, 0.0);
+    for (size_t j = 0; j < n; ++j) {
+        // Pozycja w siatce: exp(2 pi i k x / M) = exp(2 pi i k df t)
+        double x = std::fmod((times[j] - times[0]) * scale, static_cast<double>(fft_size));
+        double x2 = std::fmod(2.0 * x, static_cast<double>(fft_size));
+        Extirpolate(signal[j] - mean, x, data_grid, order);
+        Extirpolate(1.0, x2, unit_grid, order);
     }
     
-    // Okno Hann
-    std::vector<double> window(window_size);
-    double window_sum = 0.0;
-    for (size_t i = 0; i < window_size; ++i) {
-        window[i] = 0.5 * (1.0 - std::cos(2.0 * M_PI * i / (window_size - 1)));
-        window_sum += window[i] * window[i];
+    auto fft = RealFFT::ForSize(fft_size);
+    std::vector<std::complex<double>> data_spectrum(fft->SpectrumSize());
+    std::vector<std::complex<double>> unit_spectrum(fft->SpectrumSize());
+    std::vector<std::complex<double>> workspace;
+    fft->Forward(data_grid.data(), data_spectrum.data(), workspace);
+    fft->Forward(unit_grid.data(), unit_spectrum.data(), workspace);
+    
+    // Transformata liczy sumy z exp(-i...), więc sumy sinusów mają przeciwny znak części urojonej
+    std::vector<double> power_spectrum(count);
+    for (size_t k = 0; k < count; ++k) {
+        size_t bin = first + k;
+        double c = data_spectrum[bin].real();
+        double s = -data_spectrum[bin].imag();
+        double c2 = unit_spectrum[bin].real();
+        double s2 = -unit_spectrum[bin].imag();
+        power_spectrum[k] = LombScarglePower(c, s, c2, s2, static_cast<double>(n), variance);
     }
     
-    size_t fft_size = window_size;
-    std::vector<double> power_spectrum_sum(fft_size / 2 + 1, 0.0);
+    return power_spectrum;
+}
+
+// Periodogram Welch (z oknem i nakładaniem)
+// Gdy sygnał jest krótszy niż jeden segment, liczony jest zwykły periodogram.
+std::vector<double> WelchPeriodogram(
+    const std::vector<double>& signal,
+    double sampling_rate,
+    std::vector<double>& frequencies,
+    const SpectralOptions& options) {
     
-    // Przetwarzaj każdy segment
-    for (size_t seg = 0; seg < num_segments; ++seg) {
-        size_t start = seg * step;
-        if (start + window_size > N) break;
-        
-        // Zastosuj okno i oblicz DFT
-        std::vector<double> windowed(window_size);
-        for (size_t i = 0; i < window_size; ++i) {
-            windowed[i] = centered_signal[start + i] * window[i];
-        }
-        
-        for (size_t k = 0; k <= fft_size / 2; ++k) {
-            std::complex<double> sum(0.0, 0.0);
-            for (size_t n = 0; n < window_size; ++n) {
-                double angle = -2.0 * M_PI * k * n / fft_size;
-                sum += windowed[n] * std::complex<double>(std::cos(angle), std::sin(angle));
-            }
-            power_spectrum_sum[k] += std::norm(sum);
-        }
+    frequencies.clear();
+    if (signal.empty()) {
+        return std::vector<double>();
     }
     
-    // Uśrednij i znormalizuj
-    std::vector<double> power_spectrum(fft_size / 2 + 1);
-    double normalization = window_sum * num_segments * fft_size;
-    for (size_t k = 0; k <= fft_size / 2; ++k) {
-        power_spectrum[k] = power_spectrum_sum[k] / normalization;
+    size_t segment_size = static_cast<size_t>(std::lround(options.welch_segment_seconds * sampling_rate));
+    WelchEstimator estimator(segment_size, options.welch_overlap, options.welch_window);
+    std::vector<double> power_spectrum;
+    if (!estimator.Estimate(signal, sampling_rate, power_spectrum, frequencies)) {
+        return ClassicPeriodogram(signal, sampling_rate, frequencies);
     }
     
     return power_spectrum;
@@ -330,31 +334,85 @@ void CalculateFrequencyDomainMetrics(
     metrics.lf_hf = (metrics.hf > 1e-10) ? (metrics.lf / metrics.hf) : 0.0f;
 }
 
-HRVTimeMetrics HRVTimeProcessingService::Process(
-    const std::vector<SignalDatapoint>& datapoints,
-    const std::vector<RPeaksAnnotatedSignalDatapoint>& r_peaks,
-    int frequency,
-    HRVTimeMetrics::SpectralMethod method) {
+// Parametry częstotliwościowe HRV dla serii odstępów NN (times - chwile zakończenia odstępów [s])
+// resampler - bufor przepróbkowania wywołującego, używany ponownie przy kolejnych wywołaniach
+void CalculateSpectralMetrics(
+    const std::vector<double>& times,
+    const std::vector<double>& rr_intervals,
+    HRVTimeMetrics::SpectralMethod method,
+    const SpectralOptions& options,
+    RRResampler& resampler,
+    HRVTimeMetrics& metrics) {
     
-    HRVTimeMetrics metrics;
-    metrics.method = method;
+    // 3. Interpolacja sygnału RR (tylko dla metod wymagających równomiernego próbkowania)
+    double target_sampling_rate = resampler.SamplingRate();
+    const std::vector<double>* interpolated_rr = nullptr;
+    if (method != HRVTimeMetrics::SpectralMethod::LOMB_SCARGLE) {
+        interpolated_rr = &resampler.Resample(times, rr_intervals);
+    }
     
-    // Jeśli nie ma wykrytych pików R, zwróć domyślne wartości
-    if (r_peaks.empty()) {
-        metrics.rr_mean = 0.0f;
-        metrics.sdnn = 0.0f;
-        metrics.rmssd = 0.0f;
+    if (interpolated_rr && interpolated_rr->empty()) {
         metrics.tp = 0.0f;
         metrics.vlf = 0.0f;
         metrics.lf = 0.0f;
         metrics.hf = 0.0f;
         metrics.lf_hf = 0.0f;
-        return metrics;
+        return;
     }
     
-    // 1. Ekstrakcja odstępów RR
-    std::vector<double> rr_intervals = ExtractRRIntervals(r_peaks, frequency);
+    // 4. Oblicz periodogram w zależności od wybranej metody
+    std::vector<double> power_spectrum;
+    std::vector<double> frequencies;
     
+    if (method == HRVTimeMetrics::SpectralMethod::CLASSIC_PERIODOGRAM) {
+        power_spectrum = ClassicPeriodogram(*interpolated_rr, target_sampling_rate, frequencies);
+    } else if (method == HRVTimeMetrics::SpectralMethod::LOMB_SCARGLE) {
+        // Siatka częstotliwości f_k = k * df w zakresie [min_frequency, max_frequency]
+        double duration = times.back() - times.front();
+        if (duration > 0.0 && options.oversampling > 0.0) {
+            double df = 1.0 / (options.oversampling * duration);
+            size_t first = std::max<size_t>(1, static_cast<size_t>(std::ceil(options.min_frequency / df)));
+            size_t last = static_cast<size_t>(std::floor(options.max_frequency / df));
+            size_t count = last >= first ? last - first + 1 : 0;
+            
+            frequencies.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                frequencies[i] = (first + i) * df;
+            }
+            
+            if (static_cast<long long>(count) * static_cast<long long>(times.size()) <=
+                options.direct_lomb_scargle_limit) {
+                power_spectrum = LombScarglePeriodogram(rr_intervals, times, first, count, df);
+            } else {
+                power_spectrum = FastLombScarglePeriodogram(rr_intervals, times, first, count, df,
+                                                            options.extirpolation_order);
+            }
+        }
+    } else if (method == HRVTimeMetrics::SpectralMethod::WELCH) {
+        power_spectrum = WelchPeriodogram(*interpolated_rr, target_sampling_rate, frequencies, options);
+    }
+    
+    // 5. Oblicz parametry częstotliwościowe
+    CalculateFrequencyDomainMetrics(power_spectrum, frequencies, target_sampling_rate, metrics);
+    
+}
+
+HRVTimeProcessingService::HRVTimeProcessingService(SpectralOptions options)
+    : options_(options) {
+}
+
+HRVTimeMetrics HRVTimeProcessingService::Process(
+    const RRSeries& rr_series,
+    HRVTimeMetrics::SpectralMethod method) {
+    
+    HRVTimeMetrics metrics;
+    metrics.method = method;
+    
+    // 1. Odstępy NN i chwile ich zakończenia w sekundach (węzły interpolacji i czasy dla Lomb-Scargle)
+    const std::vector<double>& rr_intervals = rr_series.nn_intervals;
+    const std::vector<double>& times = rr_series.nn_times;
+    
+    // Jeśli nie ma odstępów NN, zwróć domyślne wartości
     if (rr_intervals.empty()) {
         metrics.rr_mean = 0.0f;
         metrics.sdnn = 0.0f;
@@ -368,60 +426,244 @@ HRVTimeMetrics HRVTimeProcessingService::Process(
     }
     
     // 2. Oblicz parametry czasowe
-    CalculateTimeDomainMetrics(rr_intervals, metrics);
+    CalculateTimeDomainMetrics(rr_intervals, rr_series.nn_successive, metrics);
     
-    // 3. Interpolacja sygnału RR
-    double target_sampling_rate = 4.0; // 4 Hz - standardowa częstotliwość dla HRV
-    std::vector<double> interpolated_rr = InterpolateRRSignal(rr_intervals, target_sampling_rate);
+    // 3-5. Interpolacja, periodogram i parametry częstotliwościowe (bufor przepróbkowania lokalny dla
+    // wywołania - usługa jest bezstanowa i może być używana równolegle)
+    RRResampler resampler(options_.resampling_rate, options_.resampling_mode);
+    CalculateSpectralMetrics(times, rr_intervals, method, options_, resampler, metrics);
     
-    if (interpolated_rr.empty()) {
-        metrics.tp = 0.0f;
-        metrics.vlf = 0.0f;
-        metrics.lf = 0.0f;
-        metrics.hf = 0.0f;
-        metrics.lf_hf = 0.0f;
-        return metrics;
-    }
+    return metrics;
+}
+
+namespace {
+    // Sumy do metryk czasowych w oknie przesuwnym - odstępy są dodawane i usuwane na brzegach okna,
+    // więc kolejne okna nie przeliczają wszystkich odstępów od nowa. Wartości są przesunięte o średnią
+    // całej serii, żeby sumy kwadratów nie traciły precyzji.
+    struct WindowAccumulator {
+        double shift = 0.0;
+        double sum = 0.0;
+        double sum_squares = 0.0;
+        size_t count = 0;
+        double diff_squares = 0.0;
+        size_t diff_count = 0;
+
+        void Add(double rr) {
+            const double v = rr - shift;
+            sum += v;
+            sum_squares += v * v;
+            ++count;
+        }
+
+        void Remove(double rr) {
+            const double v = rr - shift;
+            sum -= v;
+            sum_squares -= v * v;
+            --count;
+        }
+
+        void AddDiff(double diff) {
+            diff_squares += diff * diff;
+            ++diff_count;
+        }
+
+        void RemoveDiff(double diff) {
+            diff_squares -= diff * diff;
+            --diff_count;
+        }
+
+        void Fill(HRVTimeMetrics& metrics) const {
+            metrics.rr_mean = 0.0f;
+            metrics.sdnn = 0.0f;
+            metrics.rmssd = 0.0f;
+            if (count == 0) return;
+            const double mean = sum / count;
+            metrics.rr_mean = static_cast<float>(shift + mean);
+            metrics.sdnn = static_cast<float>(std::sqrt(std::max(0.0, sum_squares / count - mean * mean)));
+            if (diff_count > 0)
+                metrics.rmssd = static_cast<float>(std::sqrt(std::max(0.0, diff_squares) / diff_count));
+        }
+    };
+}
+
+HRVWindowSeries HRVTimeProcessingService::ProcessWindowed(
+    const RRSeries& rr_series,
+    double window_seconds,
+    double step_seconds,
+    HRVTimeMetrics::SpectralMethod method) {
     
-    // 4. Oblicz periodogram w zależności od wybranej metody
-    std::vector<double> power_spectrum;
-    std::vector<double> frequencies;
+    HRVWindowSeries series;
+    series.window_seconds = window_seconds;
+    series.step_seconds = step_seconds;
     
-    if (method == HRVTimeMetrics::SpectralMethod::CLASSIC_PERIODOGRAM) {
-        power_spectrum = ClassicPeriodogram(interpolated_rr, target_sampling_rate);
-        // Generuj wektor częstotliwości
-        frequencies.resize(power_spectrum.size());
-        for (size_t i = 0; i < frequencies.size(); ++i) {
-            frequencies[i] = i * target_sampling_rate / (2.0 * power_spectrum.size());
+    const std::vector<double>& rr_intervals = rr_series.nn_intervals;
+    const std::vector<double>& times = rr_series.nn_times;
+    const std::vector<bool>& successive = rr_series.nn_successive;
+    if (rr_intervals.empty() || window_seconds <= 0.0 || step_seconds <= 0.0) {
+        return series;
+    }
+    
+    // Okno obejmuje odstępy kończące się w [start, start + window_seconds)
+    const double first_time = times.front() - rr_intervals.front() / 1000.0;
+    const double last_time = times.back();
+    if (last_time - first_time < window_seconds) {
+        return series;
+    }
+    const size_t window_count = static_cast<size_t>(std::floor((last_time - first_time - window_seconds) / step_seconds)) + 1;
+    
+    series.start_times.resize(window_count);
+    series.nn_counts.resize(window_count);
+    series.windows.resize(window_count);
+    std::vector<size_t> window_begin(window_count), window_end(window_count);
+    
+    // 1. Metryki czasowe - jeden przebieg po serii z dodawaniem i usuwaniem odstępów na brzegach okna
+    WindowAccumulator accumulator;
+    accumulator.shift = std::accumulate(rr_intervals.begin(), rr_intervals.end(), 0.0) / rr_intervals.size();
+    size_t lo = 0, hi = 0;
+    for (size_t w = 0; w < window_count; ++w) {
+        const double start = first_time + w * step_seconds;
+        const double end = start + window_seconds;
+        
+        // Usuń odstępy sprzed początku okna (razem z różnicą do następnego odstępu)
+        for (; lo < hi && times[lo] < start; ++lo) {
+            accumulator.Remove(rr_intervals[lo]);
+            if (lo + 1 < hi && successive[lo + 1]) {
+                accumulator.RemoveDiff(rr_intervals[lo + 1] - rr_intervals[lo]);
+            }
         }
-    } else if (method == HRVTimeMetrics::SpectralMethod::LOMB_SCARGLE) {
-        // Dla Lomb-Scargle potrzebujemy nieregularnych czasów
-        std::vector<double> times;
-        double cumulative_time = 0.0;
-        for (size_t i = 0; i < rr_intervals.size(); ++i) {
-            times.push_back(cumulative_time);
-            cumulative_time += rr_intervals[i];
+        // Okno nie ma części wspólnej z poprzednim (krok dłuższy niż okno) - zacznij od zera
+        if (lo == hi) {
+            accumulator = WindowAccumulator{accumulator.shift};
+            for (; hi < times.size() && times[hi] < start; ++hi) {
+            }
+            lo = hi;
         }
-        
-        // Generuj częstotliwości do analizy (0.0033 - 0.4 Hz)
-        size_t num_freqs = 200;
-        frequencies.resize(num_freqs);
-        for (size_t i = 0; i < num_freqs; ++i) {
-            frequencies[i] = 0.0033 + (0.4 - 0.0033) * i / (num_freqs - 1);
+        // Dodaj odstępy kończące się przed końcem okna
+        for (; hi < times.size() && times[hi] < end; ++hi) {
+            accumulator.Add(rr_intervals[hi]);
+            if (hi > lo && successive[hi]) {
+                accumulator.AddDiff(rr_intervals[hi] - rr_intervals[hi - 1]);
+            }
         }
         
-        power_spectrum = LombScarglePeriodogram(rr_intervals, times, frequencies);
-    } else if (method == HRVTimeMetrics::SpectralMethod::WELCH) {
-        power_spectrum = WelchPeriodogram(interpolated_rr, target_sampling_rate);
-        // Generuj wektor częstotliwości
-        frequencies.resize(power_spectrum.size());
-        for (size_t i = 0; i < frequencies.size(); ++i) {
-            frequencies[i] = i * target_sampling_rate / (2.0 * power_spectrum.size());
+        HRVTimeMetrics& metrics = series.windows[w];
+        metrics.method = method;
+        accumulator.Fill(metrics);
+        series.start_times[w] = start;
+        series.nn_counts[w] = static_cast<int>(accumulator.count);
+        window_begin[w] = lo;
+        window_end[w] = hi;
+    }
+    
+    // 2. Parametry częstotliwościowe - okna są niezależne, więc liczone są równolegle. Każdy fragment ma
+    // własny bufor przepróbkowania, a plany FFT dla powtarzających się długości pochodzą z pamięci podręcznej.
+    ParallelForRange(window_count, 8, [&](size_t from, size_t to) {
+        RRResampler resampler(options_.resampling_rate, options_.resampling_mode);
+        std::vector<double> window_times, window_intervals;
+        for (size_t w = from; w < to; ++w) {
+            window_times.assign(times.begin() + window_begin[w], times.begin() + window_end[w]);
+            window_intervals.assign(rr_intervals.begin() + window_begin[w], rr_intervals.begin() + window_end[w]);
+            if (window_intervals.size() < 2) {
+                CalculateFrequencyDomainMetrics({}, {}, resampler.SamplingRate(), series.windows[w]);
+                continue;
+            }
+            CalculateSpectralMetrics(window_times, window_intervals, method, options_, resampler, series.windows[w]);
         }
+    });
+    
+    return series;
+}
+
+HRVSpectrogram HRVTimeProcessingService::ComputeSpectrogram(
+    const RRSeries& rr_series,
+    double window_seconds,
+    double step_seconds) {
+    
+    HRVSpectrogram spectrogram;
+    spectrogram.window_seconds = window_seconds;
+    spectrogram.step_seconds = step_seconds;
+    
+    const std::vector<double>& times = rr_series.nn_times;
+    if (rr_series.nn_intervals.size() < 2 || window_seconds <= 0.0 || step_seconds <= 0.0) {
+        return spectrogram;
     }
     
-    // 5. Oblicz parametry częstotliwościowe
-    CalculateFrequencyDomainMetrics(power_spectrum, frequencies, target_sampling_rate, metrics);
+    // Seria przepróbkowana raz dla całego zapisu, ramki są jej kolejnymi fragmentami
+    RRResampler resampler(options_.resampling_rate, options_.resampling_mode);
+    const double sampling_rate = resampler.SamplingRate();
+    const std::vector<double>& resampled = resampler.Resample(times, rr_series.nn_intervals);
+    const size_t window_size = static_cast<size_t>(std::lround(window_seconds * sampling_rate));
+    const size_t step = std::max<size_t>(1, static_cast<size_t>(std::lround(step_seconds * sampling_rate)));
+    if (window_size < 2 || resampled.size() < window_size) {
+        return spectrogram;
+    }
     
-    return metrics;
+    const auto window = SpectralWindow::ForSize(window_size, WindowType::Hann);
+    const size_t fft_size = RealFFT::NextFastSize(window_size);
+    const auto fft = RealFFT::ForSize(fft_size);
+    const double frequency_step = sampling_rate / fft_size;
+    const auto bins_below = [&](double frequency) {
+        return std::min(fft->SpectrumSize(), static_cast<size_t>(std::floor(frequency / frequency_step)) + 1);
+    };
+    // Zapisywane prążki sięgają spectrogram_max_frequency, moc w pasmach zawsze liczona jest do 0.4 Hz (HF)
+    const size_t bins = bins_below(options_.spectrogram_max_frequency);
+    const size_t band_bins = bins_below(0.4);
+    const size_t computed_bins = std::max(bins, band_bins);
+    const size_t frames = (resampled.size() - window_size) / step + 1;
+    
+    spectrogram.frequency_step = frequency_step;
+    spectrogram.frames = frames;
+    spectrogram.bins = bins;
+    spectrogram.power.resize(frames * bins);
+    spectrogram.frame_times.resize(frames);
+    spectrogram.vlf.resize(frames);
+    spectrogram.lf.resize(frames);
+    spectrogram.hf.resize(frames);
+    
+    std::vector<double> frequencies(band_bins);
+    for (size_t k = 0; k < band_bins; ++k) {
+        frequencies[k] = k * frequency_step;
+    }
+    // Jednostronna gęstość widmowa mocy [ms^2 / Hz]: |X|^2 / (fs * suma w^2), prążki wewnętrzne podwojone.
+    // Suma |X|^2 rośnie z nfft tak jak maleje df = fs / nfft, więc moc w pasmach nie zależy od uzupełnienia
+    // zerami ani od długości okna (dla szumu białego całkowita moc to wariancja serii).
+    const double normalization = sampling_rate * window->power;
+    const size_t nyquist_bin = fft_size % 2 == 0 ? fft_size / 2 : fft->SpectrumSize();
+    
+    // Ramki są niezależne - każdy fragment ma własne bufory, plan FFT i okno są współdzielone
+    ParallelForRange(frames, 64, [&](size_t from, size_t to) {
+        std::vector<double> windowed(fft_size, 0.0);
+        std::vector<std::complex<double>> spectrum(fft->SpectrumSize());
+        std::vector<std::complex<double>> workspace;
+        std::vector<double> frame_power(computed_bins);
+        
+        for (size_t frame = from; frame < to; ++frame) {
+            const double* x = resampled.data() + frame * step;
+            const double mean = std::accumulate(x, x + window_size, 0.0) / window_size;
+            for (size_t i = 0; i < window_size; ++i) {
+                windowed[i] = (x[i] - mean) * window->coefficients[i];
+            }
+            fft->Forward(windowed.data(), spectrum.data(), workspace);
+            
+            float* row = spectrogram.power.data() + frame * bins;
+            for (size_t k = 0; k < computed_bins; ++k) {
+                const double one_sided = (k == 0 || k == nyquist_bin) ? 1.0 : 2.0;
+                frame_power[k] = one_sided * std::norm(spectrum[k]) / normalization;
+            }
+            for (size_t k = 0; k < bins; ++k) {
+                row[k] = static_cast<float>(frame_power[k]);
+            }
+            
+            // Moc w pasmach z tego samego widma
+            HRVTimeMetrics bands;
+            CalculateFrequencyDomainMetrics(frame_power, frequencies, sampling_rate, bands);
+            spectrogram.vlf[frame] = bands.vlf;
+            spectrogram.lf[frame] = bands.lf;
+            spectrogram.hf[frame] = bands.hf;
+            spectrogram.frame_times[frame] = static_cast<float>(
+                times.front() + (frame * step + 0.5 * window_size) / sampling_rate);
+        }
+    });
+    
+    return spectrogram;
 }
@@ -1,6 +1,48 @@
 #include "../../include/service/moving_average_filter_service.h"
+#include <algorithm>
 #include <iostream>
 
+namespace {
+    // Liczba próbek czytanych naraz z zapisu 16-bitowego
+    constexpr size_t FILTER_BLOCK = 65536;
+
+    // Średnia ruchoma ze stanem zachowywanym między kolejnymi blokami próbek - ostatnie window_size
+    // próbek każdego kanału są trzymane w buforze cyklicznym, żeby usunąć najstarszą także z poprzedniego bloku
+    class MovingAverageWindow {
+        size_t window_size_;
+        size_t numChannels_;
+        std::vector<double> sum_; // suma wartości aktualnego okna
+        std::vector<float> history_;
+        size_t seen_ = 0;
+
+    public:
+        MovingAverageWindow(size_t window_size, size_t numChannels)
+            : window_size_(window_size), numChannels_(numChannels), sum_(numChannels, 0.0),
+              history_(window_size * numChannels, 0.0f) {
+        }
+
+        void Process(const SignalDatapoint* values, size_t count, SignalDatapoint* filtered) {
+            for (size_t i = 0; i < count; ++i, ++seen_) {
+                filtered[i].channelValues.resize(numChannels_);
+                float* oldest = history_.data() + (seen_ % window_size_) * numChannels_;
+
+                // Liczba próbek w bieżącym oknie (dla początku sygnału)
+                const size_t current_window = std::min(seen_ + 1, window_size_);
+                for (size_t ch = 0; ch < numChannels_; ++ch) {
+                    const float x = values[i].channelValues[ch];
+                    sum_[ch] += x;
+                    // Jeśli przekroczono długość okna to wykonanie usunięcia najstarszej próbki z sumy
+                    if (seen_ >= window_size_)
+                        sum_[ch] -= oldest[ch];
+                    oldest[ch] = x;
+
+                    filtered[i].channelValues[ch] = static_cast<float>(sum_[ch] / current_window);
+                }
+            }
+        }
+    };
+}
+
 std::vector<SignalDatapoint> MovingAverageFilterService::Filter(const std::vector<SignalDatapoint>& values) {
     std::vector<SignalDatapoint> filtered(values.size()); // tworzenie wektora o takiej samej długości jak values
     int window_size = 5;  // rozmiar okna
@@ -11,24 +53,28 @@ std::vector<SignalDatapoint> MovingAverageFilterService::Filter(const std::vecto
     if (values[0].channelValues.empty())
         return values;
 
-    const size_t numChannels = values[0].channelValues.size();
-    std::vector<double> sum(numChannels, 0.0); // suma wartości aktualnego okna
+    MovingAverageWindow window(window_size, values[0].channelValues.size());
+    window.Process(values.data(), values.size(), filtered.data());
 
-    for (size_t i = 0; i < values.size(); ++i) {
-        filtered[i].channelValues.resize(numChannels);
+    std::cout << "Moving average filter finished" << std::endl;
 
-        for (size_t ch = 0; ch < numChannels; ++ch) {
-            sum[ch] += values[i].channelValues[ch];
-            // Jeśli przekroczono długość okna to wykonanie usunięcia najstarszej próbki z sumy
-            if (i >= static_cast<size_t>(window_size))
-                sum[ch] -= values[i - window_size].channelValues[ch];
+    return filtered;
+}
 
-            // Liczba próbek w bieżącym oknie (dla początku sygnału)
-            size_t current_window = (i + 1 < static_cast<size_t>(window_size)) ? (i + 1) : window_size;
-            float avg = static_cast<float>(sum[ch] / current_window);
+std::vector<SignalDatapoint> MovingAverageFilterService::Filter(const SignalDataset& dataset) {
+    if (!dataset.compact) return Filter(dataset.values);
 
-            filtered[i].channelValues[ch] = avg;
-        }
+    const size_t n = dataset.Size();
+    int window_size = 5;  // rozmiar okna
+    if (n == 0 || dataset.ChannelCount() == 0)
+        return dataset.Samples(0, n);
+
+    // Zapis 16-bitowy - bloki rozwijane do float tylko na czas filtracji
+    std::vector<SignalDatapoint> filtered(n);
+    MovingAverageWindow window(window_size, dataset.ChannelCount());
+    for (size_t from = 0; from < n; from += FILTER_BLOCK) {
+        const std::vector<SignalDatapoint> block = dataset.Samples(from, std::min(FILTER_BLOCK, n - from));
+        window.Process(block.data(), block.size(), filtered.data() + from);
     }
 
     std::cout << "Moving average filter finished" << std::endl;
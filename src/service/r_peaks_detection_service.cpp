@@ -1,4 +1,6 @@
 #include "../../include/service/r_peaks_detection_service.h"
+#include "../../include/service/streaming_r_peaks_detector.h"
+#include <cstdint>
 #include <vector>
 #include <iostream>
 #include <cmath>
@@ -14,6 +16,7 @@ namespace {
             case RPeaksDetectionMethod::PanTompkins: return "Pan-Tompkins";
             case RPeaksDetectionMethod::Hilbert: return "Hilbert";
             case RPeaksDetectionMethod::Wavelet: return "Wavelet";
+            case RPeaksDetectionMethod::MultiLead: return "Multi-lead";
             default: return "Unknown";
         }
     }
@@ -35,8 +38,8 @@ namespace {
     // ===============================================================
     // ====================== PAN–TOMPKINS ===========================
     // ===============================================================
-    std::vector<int> DetectPeaksPanTompkins(const std::vector<float> &signal, int frequency) {
-        std::vector<int> peaks;
+    std::vector<int64_t> DetectPeaksPanTompkins(const std::vector<float> &signal, int frequency) {
+        std::vector<int64_t> peaks;
         if (signal.size() < 5) return peaks;
 
         std::vector<float> diff(signal.size());
@@ -76,15 +79,15 @@ namespace {
             thr = 0.3f * (*std::max_element(energy.begin(), energy.end()));
 
         int refractory = frequency / 5;
-        int last = -refractory;
+        int64_t last = -refractory;
 
         for (size_t i = 1; i + 1 < energy.size(); ++i) {
             if (energy[i] >= thr &&
                 energy[i] >= energy[i - 1] &&
                 energy[i] >= energy[i + 1] &&
-                (int) i - last >= refractory) {
-                peaks.push_back((int) i);
-                last = (int) i;
+                static_cast<int64_t>(i) - last >= refractory) {
+                peaks.push_back(static_cast<int64_t>(i));
+                last = static_cast<int64_t>(i);
             }
         }
 
@@ -94,8 +97,8 @@ namespace {
     // ===============================================================
     // ======================= HILBERT ===============================
     // ===============================================================
-    std::vector<int> DetectPeaksHilbert(const std::vector<float> &signal, int frequency) {
-        std::vector<int> peaks;
+    std::vector<int64_t> DetectPeaksHilbert(const std::vector<float> &signal, int frequency) {
+        std::vector<int64_t> peaks;
         if (signal.size() < 20) return peaks;
 
         int order = frequency / 10;
@@ -147,15 +150,15 @@ namespace {
             thr = 0.3f * (*std::max_element(smoothed.begin(), smoothed.end()));
 
         int refractory = frequency / 5;
-        int last = -refractory;
+        int64_t last = -refractory;
 
         for (size_t i = 1; i + 1 < smoothed.size(); ++i) {
             if (smoothed[i] >= thr &&
                 smoothed[i] >= smoothed[i - 1] &&
                 smoothed[i] >= smoothed[i + 1] &&
-                (int) i - last >= refractory) {
-                peaks.push_back((int) i);
-                last = (int) i;
+                static_cast<int64_t>(i) - last >= refractory) {
+                peaks.push_back(static_cast<int64_t>(i));
+                last = static_cast<int64_t>(i);
             }
         }
 
@@ -165,8 +168,8 @@ namespace {
     // ===============================================================
     // ========================= WAVELET =============================
     // ===============================================================
-    std::vector<int> DetectPeaksWavelet(const std::vector<float> &signal, int frequency) {
-        std::vector<int> peaks;
+    std::vector<int64_t> DetectPeaksWavelet(const std::vector<float> &signal, int frequency) {
+        std::vector<int64_t> peaks;
         if (signal.size() < 20) return peaks;
 
         int smin = 2;
@@ -213,21 +216,244 @@ namespace {
             thr = 0.3f * (*std::max_element(smoothed.begin(), smoothed.end()));
 
         int refractory = frequency / 5;
-        int last = -refractory;
+        int64_t last = -refractory;
 
         for (size_t i = 1; i + 1 < smoothed.size(); ++i) {
             if (smoothed[i] >= thr &&
                 smoothed[i] >= smoothed[i - 1] &&
                 smoothed[i] >= smoothed[i + 1] &&
-                (int) i - last >= refractory) {
-                peaks.push_back((int) i);
-                last = (int) i;
+                static_cast<int64_t>(i) - last >= refractory) {
+                peaks.push_back(static_cast<int64_t>(i));
+                last = static_cast<int64_t>(i);
             }
         }
 
         return peaks;
     }
 
+    // Doprecyzowanie położenia piku w pełnej rozdzielczości: w oknie wokół przybliżonej pozycji
+    // szukamy próbki o największym odchyleniu od średniej okna (wierzchołek załamka R).
+    // Dla detekcji wieloodprowadzeniowej odchylenia każdego odprowadzenia są normalizowane
+    // do jego maksimum w oknie i sumowane.
+    int64_t RefinePeak(const std::vector<SignalDatapoint> &datapoints, int64_t center, int radius, bool all_leads) {
+        const int64_t n = static_cast<int64_t>(datapoints.size());
+        const int64_t from = std::max<int64_t>(0, center - radius);
+        const int64_t to = std::min<int64_t>(n - 1, center + radius);
+        if (from >= to) return std::clamp<int64_t>(center, 0, n - 1);
+
+        const size_t leads = all_leads ? datapoints[from].channelValues.size() : 1;
+        const size_t first_lead = all_leads ? 0 : 1;
+        const int len = static_cast<int>(to - from + 1);
+
+        std::vector<float> score(len, 0.0f);
+        for (size_t l = first_lead; l < first_lead + leads; ++l) {
+            double mean = 0.0;
+            for (int64_t i = from; i <= to; ++i) mean += datapoints[i].channelValues[l];
+            mean /= len;
+
+            float mx = 0.0f;
+            for (int i = 0; i < len; ++i) mx = std::max(mx, std::fabs(datapoints[from + i].channelValues[l] - static_cast<float>(mean)));
+            if (mx <= 0.0f) continue;
+
+            for (int i = 0; i < len; ++i)
+                score[i] += std::fabs(datapoints[from + i].channelValues[l] - static_cast<float>(mean)) / mx;
+        }
+
+        return from + (std::max_element(score.begin(), score.end()) - score.begin());
+    }
+
+    // ===============================================================
+    // ===================== WIELOODPROWADZENIOWA ====================
+    // ===============================================================
+    // Energia przestrzenna: suma po odprowadzeniach kwadratów pochodnej, każde odprowadzenie
+    // znormalizowane do jednostkowej średniej energii. Odprowadzenia płaskie lub zaszumione
+    // (kurtoza pochodnej bliska rozkładowi normalnemu - brak wyraźnych zespołów QRS) mają wagę 0,
+    // więc odłączone lub zakłócone II nie psuje detekcji.
+    // Oba przebiegi idą po próbkach, a pętla wewnętrzna po ciągłym wektorze channelValues,
+    // dzięki czemu kompilator wektoryzuje ją przez odprowadzenia.
+    std::vector<int64_t> DetectPeaksMultiLead(const std::vector<SignalDatapoint> &datapoints, int frequency) {
+        std::vector<int64_t> peaks;
+        const size_t n = datapoints.size();
+        if (n < 20 || datapoints[0].channelValues.empty()) return peaks;
+
+        const size_t leads = datapoints[0].channelValues.size();
+        for (const auto &dp: datapoints)
+            if (dp.channelValues.size() != leads) return peaks;
+
+        // 1. przebieg: momenty pochodnej dla każdego odprowadzenia
+        std::vector<double> m2(leads, 0.0);
+        std::vector<double> m4(leads, 0.0);
+        for (size_t i = 1; i < n; ++i) {
+            const float *prev = datapoints[i - 1].channelValues.data();
+            const float *cur = datapoints[i].channelValues.data();
+            for (size_t l = 0; l < leads; ++l) {
+                const double d = cur[l] - prev[l];
+                const double d2 = d * d;
+                m2[l] += d2;
+                m4[l] += d2 * d2;
+            }
+        }
+
+        std::vector<float> weights(leads, 0.0f);
+        size_t used_leads = 0;
+        for (size_t l = 0; l < leads; ++l) {
+            const double mean2 = m2[l] / (n - 1);
+            const double mean4 = m4[l] / (n - 1);
+            if (mean2 <= 1e-12) continue;
+            const double kurtosis = mean4 / (mean2 * mean2);
+            if (kurtosis >= 6.0) {
+                weights[l] = static_cast<float>(1.0 / mean2);
+                ++used_leads;
+            }
+        }
+        if (used_leads == 0) {
+            for (size_t l = 0; l < leads; ++l)
+                if (m2[l] > 1e-12) weights[l] = static_cast<float>((n - 1) / m2[l]);
+        }
+
+        // 2. przebieg: ważona suma energii
+        std::vector<float> energy(n, 0.0f);
+        for (size_t i = 1; i < n; ++i) {
+            const float *prev = datapoints[i - 1].channelValues.data();
+            const float *cur = datapoints[i].channelValues.data();
+            float acc = 0.0f;
+            for (size_t l = 0; l < leads; ++l) {
+                const float d = cur[l] - prev[l];
+                acc += weights[l] * d * d;
+            }
+            energy[i] = acc;
+        }
+
+        // Wygładzenie oknem jak w Pan-Tompkinsie
+        int window = std::max(2, frequency / 35);
+        std::vector<float> smoothed(n, 0.0f);
+        double acc = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            acc += energy[i];
+            if (i >= static_cast<size_t>(window)) acc -= energy[i - window];
+            smoothed[i] = static_cast<float>(acc / std::min<size_t>(i + 1, window));
+        }
+
+        // Suma energii po odprowadzeniach ma dużo wyższy kontrast QRS niż pojedyncze odprowadzenie,
+        // więc sam 80. percentyl przepuszczałby załamki T - próg jest dodatkowo wiązany z 99. percentylem.
+        float thr = std::max(Percentile(smoothed, 0.80f), 0.2f * Percentile(smoothed, 0.99f));
+        if (thr <= 0.0f)
+            thr = 0.3f * (*std::max_element(smoothed.begin(), smoothed.end()));
+
+        int refractory = frequency / 5;
+        int64_t last = -refractory;
+
+        // Okno wygładzania kończy się na próbce i, więc maksimum energii leży ok. window / 2 próbek za
+        // zespołem QRS - pozycja jest doprecyzowywana do wierzchołka R wokół środka okna
+        const int radius = std::max(1, frequency * 60 / 1000);
+        for (size_t i = 1; i + 1 < smoothed.size(); ++i) {
+            if (smoothed[i] >= thr &&
+                smoothed[i] >= smoothed[i - 1] &&
+                smoothed[i] >= smoothed[i + 1] &&
+                static_cast<int64_t>(i) - last >= refractory) {
+                last = static_cast<int64_t>(i);
+                const int64_t idx = RefinePeak(datapoints, last - window / 2, radius, true);
+                if (!peaks.empty() && idx - peaks.back() < refractory) continue;
+                peaks.push_back(idx);
+            }
+        }
+
+        return peaks;
+    }
+
+    // ===============================================================
+    // ===================== DETEKCJA WIELOSKALOWA ===================
+    // ===============================================================
+    std::vector<int64_t> DetectPeakIndices(const std::vector<SignalDatapoint> &datapoints,
+                                       const std::vector<float> &signal,
+                                       int frequency,
+                                       RPeaksDetectionMethod method) {
+        switch (method) {
+            case RPeaksDetectionMethod::Hilbert: return DetectPeaksHilbert(signal, frequency);
+            case RPeaksDetectionMethod::Wavelet: return DetectPeaksWavelet(signal, frequency);
+            case RPeaksDetectionMethod::MultiLead: return DetectPeaksMultiLead(datapoints, frequency);
+            case RPeaksDetectionMethod::PanTompkins:
+            default: return DetectPeaksPanTompkins(signal, frequency);
+        }
+    }
+
+    // Filtr antyaliasingowy: CIC 2. rzędu, czyli okno trójkątne o długości 2 * factor - 1.
+    // Ma zera transmitancji we wszystkich pasmach, które po decymacji nałożyłyby się na 0 Hz,
+    // a spadek wzmocnienia w paśmie QRS nie przeszkadza detekcji opartej na energii - dokładne
+    // położenie piku i tak jest ustalane w pełnej rozdzielczości. Filtr jest symetryczny
+    // i liczony wokół próbki wyjściowej, więc nie wprowadza przesunięcia w czasie.
+    std::vector<float> DesignDecimationFilter(int factor) {
+        std::vector<float> taps(2 * factor - 1);
+        for (int k = 0; k < factor; ++k)
+            taps[k] = taps[taps.size() - 1 - k] = static_cast<float>(k + 1) / (factor * factor);
+        return taps;
+    }
+
+    // Decymacja jednego odprowadzenia: filtr liczony tylko dla co factor-tej próbki (postać polifazowa)
+    std::vector<float> DecimateLead(const std::vector<SignalDatapoint> &datapoints, size_t lead, int factor,
+                                    const std::vector<float> &taps) {
+        const int half = static_cast<int>(taps.size() / 2);
+        const int64_t n = static_cast<int64_t>(datapoints.size());
+        std::vector<float> out((n + factor - 1) / factor);
+
+        for (size_t k = 0; k < out.size(); ++k) {
+            const int64_t center = static_cast<int64_t>(k) * factor;
+            const bool inside = center - half >= 0 && center + half < n;
+            float acc = 0.0f;
+            for (int j = -half; j <= half; ++j) {
+                const int64_t idx = inside ? center + j : std::clamp<int64_t>(center + j, 0, n - 1);
+                acc += taps[j + half] * datapoints[idx].channelValues[lead];
+            }
+            out[k] = acc;
+        }
+        return out;
+    }
+
+    // Decymacja wszystkich odprowadzeń naraz - pętla wewnętrzna idzie po ciągłym wektorze
+    // channelValues, więc jest wektoryzowana przez odprowadzenia
+    std::vector<SignalDatapoint> DecimateAllLeads(const std::vector<SignalDatapoint> &datapoints, int factor,
+                                                  const std::vector<float> &taps) {
+        const int half = static_cast<int>(taps.size() / 2);
+        const int64_t n = static_cast<int64_t>(datapoints.size());
+        const size_t leads = datapoints[0].channelValues.size();
+        std::vector<SignalDatapoint> out((n + factor - 1) / factor);
+
+        for (size_t k = 0; k < out.size(); ++k) {
+            const int64_t center = static_cast<int64_t>(k) * factor;
+            const bool inside = center - half >= 0 && center + half < n;
+            out[k].channelValues.assign(leads, 0.0f);
+            float *acc = out[k].channelValues.data();
+            for (int j = -half; j <= half; ++j) {
+                const float t = taps[j + half];
+                const int64_t idx = inside ? center + j : std::clamp<int64_t>(center + j, 0, n - 1);
+                const float *x = datapoints[idx].channelValues.data();
+                for (size_t l = 0; l < leads; ++l)
+                    acc[l] += t * x[l];
+            }
+        }
+        return out;
+    }
+
+    std::vector<RPeaksAnnotatedSignalDatapoint> Annotate(const std::vector<SignalDatapoint> &datapoints,
+                                                         const std::vector<int64_t> &peaks) {
+        std::vector<char> is_peak(datapoints.size(), 0);
+        for (int64_t idx: peaks)
+            if (idx >= 0 && idx < static_cast<int64_t>(datapoints.size()))
+                is_peak[idx] = 1;
+
+        std::vector<RPeaksAnnotatedSignalDatapoint> result;
+        result.reserve(datapoints.size());
+
+        for (size_t i = 0; i < datapoints.size(); ++i) {
+            RPeaksAnnotatedSignalDatapoint dp;
+            dp.channelValues = datapoints[i].channelValues;
+            dp.peak = is_peak[i] != 0;
+            result.push_back(std::move(dp));
+        }
+
+        return result;
+    }
+
     // ===============================================================
     // ====================== METRYKI / RAPORT =======================
     // ===============================================================
@@ -238,7 +464,7 @@ namespace {
         RPeaksDetectionMethod method;
     };
 
-    DetectionMetrics ComputeMetrics(const std::vector<int> &peak_indices,
+    DetectionMetrics ComputeMetrics(const std::vector<int64_t> &peak_indices,
                                     const std::vector<float> &signal,
                                     RPeaksDetectionMethod method) {
         DetectionMetrics m;
@@ -252,15 +478,15 @@ namespace {
         }
 
         double sum = 0.0;
-        for (int idx: peak_indices)
-            if (idx >= 0 && idx < (int) signal.size())
+        for (int64_t idx: peak_indices)
+            if (idx >= 0 && idx < static_cast<int64_t>(signal.size()))
                 sum += signal[idx];
 
         m.mean_amplitude = sum / peak_indices.size();
 
         double s2 = 0.0;
-        for (int idx: peak_indices) {
-            if (idx >= 0 && idx < (int) signal.size()) {
+        for (int64_t idx: peak_indices) {
+            if (idx >= 0 && idx < static_cast<int64_t>(signal.size())) {
                 double d = signal[idx] - m.mean_amplitude;
                 s2 += d * d;
             }
@@ -287,6 +513,10 @@ namespace {
     }
 } // namespace
 
+RPeaksDetectionService::RPeaksDetectionService(bool comparison_report)
+    : comparison_report_(comparison_report) {
+}
+
 // ===============================================================
 // ========================= DETECT ===============================
 // ===============================================================
@@ -299,7 +529,8 @@ std::vector<RPeaksAnnotatedSignalDatapoint> RPeaksDetectionService::Detect(
     // domyślna metoda
     if (method == RPeaksDetectionMethod::PanTompkins ||
         method == RPeaksDetectionMethod::Hilbert ||
-        method == RPeaksDetectionMethod::Wavelet) {
+        method == RPeaksDetectionMethod::Wavelet ||
+        method == RPeaksDetectionMethod::MultiLead) {
         // OK
     } else {
         method = RPeaksDetectionMethod::PanTompkins;
@@ -309,20 +540,25 @@ std::vector<RPeaksAnnotatedSignalDatapoint> RPeaksDetectionService::Detect(
     for (size_t i = 0; i < datapoints.size(); ++i)
         signal[i] = datapoints[i].channelValues[1];
 
-    std::vector<int> peaks_pan = DetectPeaksPanTompkins(signal, frequency);
-    std::vector<int> peaks_hil = DetectPeaksHilbert(signal, frequency);
-    std::vector<int> peaks_wave = DetectPeaksWavelet(signal, frequency);
+    if (!comparison_report_)
+        return Annotate(datapoints, DetectPeakIndices(datapoints, signal, frequency, method));
+
+    std::vector<int64_t> peaks_pan = DetectPeaksPanTompkins(signal, frequency);
+    std::vector<int64_t> peaks_hil = DetectPeaksHilbert(signal, frequency);
+    std::vector<int64_t> peaks_wave = DetectPeaksWavelet(signal, frequency);
+    std::vector<int64_t> peaks_multi = DetectPeaksMultiLead(datapoints, frequency);
 
     std::vector<DetectionMetrics> metrics{
         ComputeMetrics(peaks_pan, signal, RPeaksDetectionMethod::PanTompkins),
         ComputeMetrics(peaks_hil, signal, RPeaksDetectionMethod::Hilbert),
-        ComputeMetrics(peaks_wave, signal, RPeaksDetectionMethod::Wavelet)
+        ComputeMetrics(peaks_wave, signal, RPeaksDetectionMethod::Wavelet),
+        ComputeMetrics(peaks_multi, signal, RPeaksDetectionMethod::MultiLead)
     };
 
     PrintComparisonReport(metrics, frequency);
 
     // wybór metody
-    const std::vector<int> *selected = nullptr;
+    const std::vector<int64_t> *selected = nullptr;
 
     switch (method) {
         case RPeaksDetectionMethod::PanTompkins: selected = &peaks_pan;
@@ -331,20 +567,64 @@ std::vector<RPeaksAnnotatedSignalDatapoint> RPeaksDetectionService::Detect(
             break;
         case RPeaksDetectionMethod::Wavelet: selected = &peaks_wave;
             break;
+        case RPeaksDetectionMethod::MultiLead: selected = &peaks_multi;
+            break;
+    }
+
+    return Annotate(datapoints, *selected);
+}
+
+// ===============================================================
+// ====================== DETECT MULTI-RATE ======================
+// ===============================================================
+std::vector<RPeaksAnnotatedSignalDatapoint> RPeaksDetectionService::DetectMultiRate(
+    const std::vector<SignalDatapoint> &datapoints, int frequency,
+    RPeaksDetectionMethod method) {
+    if (datapoints.empty() || frequency <= 0 || datapoints[0].channelValues.size() < 2)
+        return {};
+
+    const bool all_leads = method == RPeaksDetectionMethod::MultiLead;
+
+    // Energia QRS leży poniżej ~40 Hz, więc detekcja działa przy ~125 Hz
+    const int factor = frequency / 125;
+    if (factor < 2) {
+        std::vector<float> signal(datapoints.size());
+        for (size_t i = 0; i < datapoints.size(); ++i)
+            signal[i] = datapoints[i].channelValues[1];
+        return Annotate(datapoints, DetectPeakIndices(datapoints, signal, frequency, method));
     }
 
-    const auto &final_peaks = *selected;
+    const std::vector<float> taps = DesignDecimationFilter(factor);
+    const int low_frequency = frequency / factor;
 
-    std::vector<RPeaksAnnotatedSignalDatapoint> result;
-    result.reserve(datapoints.size());
+    std::vector<float> low_signal;
+    std::vector<SignalDatapoint> low_datapoints;
+    if (all_leads) {
+        low_datapoints = DecimateAllLeads(datapoints, factor, taps);
+        low_signal.resize(low_datapoints.size());
+        for (size_t i = 0; i < low_datapoints.size(); ++i)
+            low_signal[i] = low_datapoints[i].channelValues[1];
+    } else {
+        low_signal = DecimateLead(datapoints, 1, factor, taps);
+    }
 
-    for (size_t i = 0; i < datapoints.size(); ++i) {
-        RPeaksAnnotatedSignalDatapoint dp;
-        dp.channelValues = datapoints[i].channelValues;
-        dp.peak = std::find(final_peaks.begin(), final_peaks.end(),
-                            (int) i) != final_peaks.end();
-        result.push_back(dp);
+    const std::vector<int64_t> coarse = DetectPeakIndices(low_datapoints, low_signal, low_frequency, method);
+
+    // Okno doprecyzowania: jedna próbka po decymacji plus 60 ms na przesunięcie cechy względem R
+    const int radius = factor + frequency * 60 / 1000;
+    const int refractory = frequency / 5;
+
+    std::vector<int64_t> refined;
+    refined.reserve(coarse.size());
+    for (int64_t p: coarse) {
+        const int64_t idx = RefinePeak(datapoints, p * factor, radius, all_leads);
+        if (!refined.empty() && idx - refined.back() < refractory) continue;
+        refined.push_back(idx);
     }
 
-    return result;
+    return Annotate(datapoints, refined);
+}
+
+std::unique_ptr<IStreamingRPeaksDetector> RPeaksDetectionService::CreateStreamingDetector(int frequency) {
+    return std::make_unique<StreamingRPeaksDetector>(frequency);
 }
@@ -0,0 +1,231 @@
+#include "../../include/service/signal_quality_service.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+
+namespace {
+    // Zakres zmienności poniżej którego odprowadzenie uznajemy za odłączone [mV]
+    constexpr float FLAT_RANGE = 0.02f;
+    // Tolerancja "tej samej" skrajnej wartości przy wykrywaniu nasycenia [mV]
+    constexpr float EXTREME_TOLERANCE = 1e-3f;
+    // Udział próbek na skrajnych wartościach, od którego uznajemy segment za nasycony
+    constexpr double SATURATION_FRACTION = 0.02;
+    // Kurtoza szumu gaussowskiego to 3, czysty EKG ma wyraźnie wyższą
+    constexpr double KURTOSIS_NOISE = 3.0;
+    constexpr double KURTOSIS_CLEAN = 5.0;
+    // Stosunek energii drugiej i pierwszej różnicy: biały szum daje 3, gładki EKG kilka setnych
+    constexpr double NOISE_RATIO_CLEAN = 0.3;
+    constexpr double NOISE_RATIO_NOISE = 1.0;
+    // Okno wokół uderzenia, w którym odprowadzenie powinno mieć wyraźny zespół QRS [s]
+    constexpr double BEAT_WINDOW = 0.05;
+    constexpr double BEAT_AMPLITUDE_STD = 3.0;
+    constexpr double AGREEMENT_MIN = 0.5;
+    // Minimalna ocena odprowadzenia uznanego za przydatne
+    constexpr float USABLE_SCORE = 0.5f;
+
+    // Statystyki jednego odprowadzenia w jednym segmencie, zbierane w jednym przebiegu
+    struct LeadStats {
+        double shift = 0.0;
+        double s1 = 0.0, s2 = 0.0, s3 = 0.0, s4 = 0.0;
+        double d1 = 0.0, d2 = 0.0;
+        float mn = 0.0f, mx = 0.0f;
+        int at_min = 0, at_max = 0;
+    };
+
+    double Clamp01(double v) {
+        return std::min(1.0, std::max(0.0, v));
+    }
+
+    // Odczyt surowego sygnału segmentu: count próbek od from do out, kanałami ([lead * count + k])
+    using RawSegmentReader = std::function<void(size_t from, size_t count, float *out)>;
+
+    SignalQuality AssessSegments(
+        size_t n,
+        int leads,
+        const RawSegmentReader &read_raw,
+        const std::vector<RPeaksAnnotatedSignalDatapoint> &r_peaks,
+        int frequency,
+        double segment_seconds) {
+        SignalQuality quality;
+        const int segment_length = std::max(1, static_cast<int>(segment_seconds * frequency));
+        const size_t segments = (n + segment_length - 1) / segment_length;
+
+        quality.segment_length = segment_length;
+        quality.leads = leads;
+        quality.scores.assign(segments * leads, 0.0f);
+        quality.flags.assign(segments * leads, SignalQuality::None);
+        quality.usable.assign(segments, false);
+
+        // Zakres i nasycenie oceniamy na sygnale surowym (filtr zniekształca plateau przy nasyceniu),
+        // kształt rozkładu, szum i zgodność z uderzeniami - na sygnale przefiltrowanym z detektora
+        const bool has_filtered = r_peaks.size() == n && !r_peaks[0].channelValues.empty() &&
+                                  static_cast<int>(r_peaks[0].channelValues.size()) == leads;
+
+        std::vector<int64_t> beats;
+        for (size_t i = 0; i < r_peaks.size() && i < n; ++i)
+            if (r_peaks[i].peak) beats.push_back(static_cast<int64_t>(i));
+        const int64_t beat_radius = std::max<int64_t>(1, static_cast<int64_t>(BEAT_WINDOW * frequency));
+
+        // Surowy sygnał segmentu z marginesem na różnice wsteczne i okna uderzeń przy brzegach
+        const size_t margin = static_cast<size_t>(std::max<int64_t>(2, beat_radius));
+        std::vector<float> block;
+        size_t block_from = 0, block_count = 0;
+        auto raw_at = [&](size_t i, int l) { return block[l * block_count + (i - block_from)]; };
+        auto filtered = [&](size_t i, int l) { return has_filtered ? r_peaks[i].channelValues[l] : raw_at(i, l); };
+
+        std::vector<LeadStats> stats(leads);
+        size_t next_beat = 0;
+
+        for (size_t seg = 0; seg < segments; ++seg) {
+            const size_t from = seg * segment_length;
+            const size_t to = std::min(n, from + segment_length);
+            const double len = static_cast<double>(to - from);
+
+            block_from = from > margin ? from - margin : 0;
+            block_count = std::min(n, to + margin) - block_from;
+            block.resize(block_count * leads);
+            read_raw(block_from, block_count, block.data());
+
+            for (int l = 0; l < leads; ++l) {
+                stats[l] = LeadStats{};
+                stats[l].shift = filtered(from, l);
+                stats[l].mn = stats[l].mx = raw_at(from, l);
+            }
+
+            // Jeden przebieg po próbkach segmentu: momenty, skrajne wartości i energie różnic
+            for (size_t i = from; i < to; ++i) {
+                const size_t i1 = i > 0 ? i - 1 : i;
+                const size_t i2 = i > 1 ? i - 2 : i1;
+
+                for (int l = 0; l < leads; ++l) {
+                    LeadStats &s = stats[l];
+                    const float x = filtered(i, l);
+                    const float x1 = filtered(i1, l);
+                    const float x2 = filtered(i2, l);
+                    const float raw = raw_at(i, l);
+                    const double v = x - s.shift;
+                    const double v2 = v * v;
+                    s.s1 += v;
+                    s.s2 += v2;
+                    s.s3 += v2 * v;
+                    s.s4 += v2 * v2;
+
+                    const double d1 = x - x1;
+                    const double d2 = x - 2.0 * x1 + x2;
+                    s.d1 += d1 * d1;
+                    s.d2 += d2 * d2;
+
+                    s.mx = std::max(s.mx, raw);
+                    s.mn = std::min(s.mn, raw);
+                }
+            }
+
+            // Drugi przebieg: próbki w tolerancji od ostatecznych wartości skrajnych segmentu. Liczniki
+            // aktualizowane w pierwszym przebiegu zliczałyby też powolny dryf kończący się na maksimum.
+            for (int l = 0; l < leads; ++l) {
+                LeadStats &s = stats[l];
+                const float *raw = block.data() + l * block_count + (from - block_from);
+                for (size_t k = 0; k < to - from; ++k) {
+                    if (raw[k] >= s.mx - EXTREME_TOLERANCE) ++s.at_max;
+                    if (raw[k] <= s.mn + EXTREME_TOLERANCE) ++s.at_min;
+                }
+            }
+
+            // Uderzenia wykryte w tym segmencie
+            while (next_beat < beats.size() && beats[next_beat] < static_cast<int64_t>(from)) ++next_beat;
+            size_t beat_end = next_beat;
+            while (beat_end < beats.size() && beats[beat_end] < static_cast<int64_t>(to)) ++beat_end;
+            const size_t beat_count = beat_end - next_beat;
+
+            int usable_leads = 0;
+            for (int l = 0; l < leads; ++l) {
+                const LeadStats &s = stats[l];
+                uint8_t flags = SignalQuality::None;
+
+                const double mean = s.s1 / len;
+                const double var = std::max(0.0, s.s2 / len - mean * mean);
+                const double m4 = s.s4 / len - 4.0 * mean * s.s3 / len + 6.0 * mean * mean * s.s2 / len
+                                  - 3.0 * mean * mean * mean * mean;
+                const double kurtosis = var > 1e-12 ? m4 / (var * var) : 0.0;
+                const double noise_ratio = s.d1 > 1e-12 ? s.d2 / s.d1 : 0.0;
+
+                if (s.mx - s.mn < FLAT_RANGE) flags |= SignalQuality::Flatline;
+                if ((s.at_max + s.at_min) / len > SATURATION_FRACTION && !(flags & SignalQuality::Flatline))
+                    flags |= SignalQuality::Saturation;
+                if (kurtosis < KURTOSIS_CLEAN) flags |= SignalQuality::LowKurtosis;
+                if (noise_ratio > NOISE_RATIO_CLEAN) flags |= SignalQuality::Noise;
+
+                double agreement = 1.0;
+                if (beat_count > 0 && var > 1e-12) {
+                    const double threshold = BEAT_AMPLITUDE_STD * std::sqrt(var);
+                    size_t agreeing = 0;
+                    for (size_t b = next_beat; b < beat_end; ++b) {
+                        const int64_t lo = std::max<int64_t>(0, beats[b] - beat_radius);
+                        const int64_t hi = std::min<int64_t>(static_cast<int64_t>(n) - 1, beats[b] + beat_radius);
+                        float wmin = filtered(lo, l);
+                        float wmax = wmin;
+                        for (int64_t i = lo + 1; i <= hi; ++i) {
+                            const float v = filtered(i, l);
+                            wmin = std::min(wmin, v);
+                            wmax = std::max(wmax, v);
+                        }
+                        if (wmax - wmin >= threshold) ++agreeing;
+                    }
+                    agreement = static_cast<double>(agreeing) / beat_count;
+                    if (agreement < AGREEMENT_MIN) flags |= SignalQuality::NoBeatAgreement;
+                }
+
+                double score = 0.0;
+                if (!(flags & (SignalQuality::Flatline | SignalQuality::Saturation))) {
+                    const double kurtosis_factor = Clamp01((kurtosis - KURTOSIS_NOISE) / (KURTOSIS_CLEAN - KURTOSIS_NOISE));
+                    const double noise_factor = Clamp01(
+                        (NOISE_RATIO_NOISE - noise_ratio) / (NOISE_RATIO_NOISE - NOISE_RATIO_CLEAN));
+                    score = kurtosis_factor * noise_factor * agreement;
+                }
+
+                quality.scores[seg * leads + l] = static_cast<float>(score);
+                quality.flags[seg * leads + l] = flags;
+                if (score >= USABLE_SCORE) ++usable_leads;
+            }
+
+            // Segment jest przydatny, gdy co najmniej połowa odprowadzeń ma dobrą jakość
+            quality.usable[seg] = usable_leads * 2 >= leads;
+        }
+
+        return quality;
+    }
+}
+
+SignalQualityService::SignalQualityService(double segment_seconds)
+    : segment_seconds_(segment_seconds) {
+}
+
+SignalQuality SignalQualityService::Assess(
+    const std::vector<SignalDatapoint> &datapoints,
+    const std::vector<RPeaksAnnotatedSignalDatapoint> &r_peaks,
+    int frequency) {
+    if (datapoints.empty() || datapoints[0].channelValues.empty() || frequency <= 0)
+        return SignalQuality();
+
+    const int leads = static_cast<int>(datapoints[0].channelValues.size());
+    auto read_raw = [&](size_t from, size_t count, float *out) {
+        for (size_t k = 0; k < count; ++k)
+            for (int l = 0; l < leads; ++l) out[l * count + k] = datapoints[from + k].channelValues[l];
+    };
+    return AssessSegments(datapoints.size(), leads, read_raw, r_peaks, frequency, segment_seconds_);
+}
+
+SignalQuality SignalQualityService::Assess(
+    const SignalDataset &dataset,
+    const std::vector<RPeaksAnnotatedSignalDatapoint> &r_peaks) {
+    if (dataset.Size() == 0 || dataset.ChannelCount() == 0 || dataset.frequency <= 0)
+        return SignalQuality();
+
+    // Zapis 16-bitowy jest czytany segmentami prosto z buforów kanałów, bez rozwijania całego sygnału
+    const int leads = static_cast<int>(dataset.ChannelCount());
+    auto read_raw = [&](size_t from, size_t count, float *out) {
+        for (int l = 0; l < leads; ++l) dataset.ReadChannel(l, from, count, out + l * count);
+    };
+    return AssessSegments(dataset.Size(), leads, read_raw, r_peaks, dataset.frequency, segment_seconds_);
+}
@@ -0,0 +1,189 @@
+#include "../../include/service/streaming_r_peaks_detector.h"
+#include <algorithm>
+#include <cmath>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+double StreamingRPeaksDetector::Biquad::Step(double x0) {
+    double y0 = b0 * x0 + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+    x2 = x1;
+    x1 = x0;
+    y2 = y1;
+    y1 = y0;
+    return y0;
+}
+
+StreamingRPeaksDetector::StreamingRPeaksDetector(int frequency, int lead)
+    : frequency_(std::max(1, frequency)), lead_(lead) {
+    integration_window_ = std::max(2, frequency_ * 150 / 1000);
+    confirm_window_ = std::max(1, frequency_ * 120 / 1000);
+    filter_delay_ = std::max(1, frequency_ / 50);
+    refractory_ = std::max(1, frequency_ / 5);
+    learning_samples_ = 2 * frequency_;
+
+    // Współczynniki jak w ButterworthFilterService (przekształcenie biliniowe, 2. rząd)
+    const double fs = static_cast<double>(frequency_);
+    const double fc_high = std::min(5.0, 0.2 * fs);
+    const double fc_low = std::min(15.0, 0.45 * fs);
+
+    double K = std::tan(M_PI * fc_high / fs);
+    double K2 = K * K;
+    double norm = 1.0 / (1.0 + std::sqrt(2.0) * K + K2);
+    high_pass_.b0 = norm;
+    high_pass_.b1 = -2.0 * norm;
+    high_pass_.b2 = norm;
+    high_pass_.a1 = 2.0 * (K2 - 1.0) * norm;
+    high_pass_.a2 = (1.0 - std::sqrt(2.0) * K + K2) * norm;
+
+    K = std::tan(M_PI * fc_low / fs);
+    K2 = K * K;
+    norm = 1.0 / (1.0 + std::sqrt(2.0) * K + K2);
+    low_pass_.b0 = K2 * norm;
+    low_pass_.b1 = 2.0 * low_pass_.b0;
+    low_pass_.b2 = low_pass_.b0;
+    low_pass_.a1 = 2.0 * (K2 - 1.0) * norm;
+    low_pass_.a2 = (1.0 - std::sqrt(2.0) * K + K2) * norm;
+
+    filtered_history_.assign(integration_window_ + filter_delay_ + 2, 0.0);
+    squared_history_.assign(integration_window_, 0.0);
+}
+
+std::vector<int64_t> StreamingRPeaksDetector::Push(const std::vector<SignalDatapoint> &block) {
+    std::vector<int64_t> confirmed;
+    for (const auto &dp: block) {
+        double x = lead_ >= 0 && lead_ < static_cast<int>(dp.channelValues.size()) ? dp.channelValues[lead_] : 0.0;
+        ProcessSample(x, confirmed);
+    }
+    return confirmed;
+}
+
+std::vector<int64_t> StreamingRPeaksDetector::Flush() {
+    std::vector<int64_t> confirmed;
+    if (learning_ && sample_index_ > 0)
+        FinishLearning(confirmed);
+
+    if (has_candidate_) {
+        confirmed.push_back(candidate_.r_index);
+        last_r_index_ = candidate_.r_index;
+        has_candidate_ = false;
+    }
+    return confirmed;
+}
+
+void StreamingRPeaksDetector::Reset() {
+    *this = StreamingRPeaksDetector(frequency_, lead_);
+}
+
+int StreamingRPeaksDetector::GetMaxDecisionDelay() const {
+    // R jest szukany najdalej integration_window_ + filter_delay_ przed maksimum okna całkującego,
+    // maksimum jest rozpoznawane jedną próbkę później, a potwierdzane po confirm_window_.
+    return integration_window_ + filter_delay_ + confirm_window_ + 1;
+}
+
+void StreamingRPeaksDetector::ProcessSample(double x, std::vector<int64_t> &confirmed) {
+    const int64_t n = sample_index_;
+
+    // 1. Filtr pasmowy 5-15 Hz
+    const double bp = low_pass_.Step(high_pass_.Step(x));
+    filtered_history_[n % filtered_history_.size()] = bp;
+
+    // 2. Pochodna pięciopunktowa (Pan-Tompkins) i kwadrat
+    const double d = (2.0 * bp + derivative_state_[0] - derivative_state_[2] - 2.0 * derivative_state_[3]) / 8.0;
+    derivative_state_[3] = derivative_state_[2];
+    derivative_state_[2] = derivative_state_[1];
+    derivative_state_[1] = derivative_state_[0];
+    derivative_state_[0] = bp;
+    const double squared = d * d;
+
+    // 3. Całkowanie w ruchomym oknie
+    double &oldest = squared_history_[n % integration_window_];
+    integrator_sum_ += squared - oldest;
+    oldest = squared;
+    if (integrator_sum_ < 0.0) integrator_sum_ = 0.0;
+    const double mwi = integrator_sum_ / integration_window_;
+
+    // 4. Lokalne maksimum sygnału scałkowanego w próbce n - 1
+    if (n >= 2 && mwi_prev_ > mwi_prev2_ && mwi_prev_ >= mwi) {
+        LocalMax local_max{mwi_prev_, n - 1, LocateR(n - 1)};
+        if (learning_)
+            learning_maxima_.push_back(local_max);
+        else
+            HandleLocalMax(local_max, n, confirmed);
+    }
+
+    mwi_prev2_ = mwi_prev_;
+    mwi_prev_ = mwi;
+    ++sample_index_;
+
+    if (learning_) {
+        learning_max_ = std::max(learning_max_, mwi);
+        learning_sum_ += mwi;
+        if (sample_index_ >= learning_samples_)
+            FinishLearning(confirmed);
+    } else {
+        ConfirmCandidateIfDue(n, confirmed);
+    }
+}
+
+void StreamingRPeaksDetector::HandleLocalMax(const LocalMax &local_max, int64_t now, std::vector<int64_t> &confirmed) {
+    ConfirmCandidateIfDue(now, confirmed);
+
+    if (local_max.value < Threshold()) {
+        npki_ = 0.125 * local_max.value + 0.875 * npki_;
+        return;
+    }
+
+    if (last_r_index_ >= 0 && local_max.r_index - last_r_index_ < refractory_)
+        return;
+
+    if (!has_candidate_ || local_max.value > candidate_.value) {
+        candidate_ = local_max;
+        has_candidate_ = true;
+    }
+}
+
+void StreamingRPeaksDetector::ConfirmCandidateIfDue(int64_t now, std::vector<int64_t> &confirmed) {
+    if (!has_candidate_ || now - candidate_.mwi_index < confirm_window_)
+        return;
+
+    confirmed.push_back(candidate_.r_index);
+    spki_ = 0.125 * candidate_.value + 0.875 * spki_;
+    last_r_index_ = candidate_.r_index;
+    has_candidate_ = false;
+}
+
+void StreamingRPeaksDetector::FinishLearning(std::vector<int64_t> &confirmed) {
+    learning_ = false;
+    spki_ = learning_max_ / 3.0;
+    npki_ = 0.5 * learning_sum_ / std::max<int64_t>(1, sample_index_);
+
+    // Odtworzenie maksimów z fazy uczenia z już ustalonymi progami
+    for (const auto &local_max: learning_maxima_)
+        HandleLocalMax(local_max, local_max.mwi_index + 1, confirmed);
+    learning_maxima_.clear();
+    learning_maxima_.shrink_to_fit();
+
+    ConfirmCandidateIfDue(sample_index_ - 1, confirmed);
+}
+
+int64_t StreamingRPeaksDetector::LocateR(int64_t mwi_index) const {
+    const int64_t size = static_cast<int64_t>(filtered_history_.size());
+    const int64_t from = std::max<int64_t>(0, mwi_index - integration_window_ - filter_delay_);
+
+    int64_t best = mwi_index;
+    double best_value = -1.0;
+    for (int64_t j = from; j <= mwi_index; ++j) {
+        double v = std::fabs(filtered_history_[j % size]);
+        if (v > best_value) {
+            best_value = v;
+            best = j;
+        }
+    }
+    return best;
+}
+
+double StreamingRPeaksDetector::Threshold() const {
+    return npki_ + 0.25 * (spki_ - npki_);
+}
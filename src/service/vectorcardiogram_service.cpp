@@ -0,0 +1,121 @@
+#include "../../include/service/vectorcardiogram_service.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "../../include/model/signal_dataset.h"
+#include "../../include/util/parallel_for.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+    constexpr size_t INPUT_LEADS = 8;
+
+    // Kolejność wejść macierzy: V1..V6, I, II
+    constexpr size_t INPUT_ORDER[INPUT_LEADS] = {
+        SignalDataset::V1, SignalDataset::V2, SignalDataset::V3, SignalDataset::V4,
+        SignalDataset::V5, SignalDataset::V6, SignalDataset::I, SignalDataset::II
+    };
+
+    // Odwrotna macierz Dowera
+    constexpr float INVERSE_DOWER[3][INPUT_LEADS] = {
+        {-0.172f, -0.074f, 0.122f, 0.231f, 0.239f, 0.194f, 0.156f, -0.010f},
+        {0.057f, -0.019f, -0.106f, -0.022f, 0.041f, 0.048f, -0.227f, 0.887f},
+        {-0.229f, -0.310f, -0.246f, -0.063f, 0.055f, 0.108f, 0.022f, 0.102f}
+    };
+
+    // Liczba próbek w bloku (8 buforów po BLOCK_SIZE liczb float mieści się w L1)
+    constexpr size_t BLOCK_SIZE = 256;
+    // Liczba próbek przetwarzanych przez jeden wątek naraz
+    constexpr size_t PARALLEL_GRAIN = 64 * BLOCK_SIZE;
+
+    // Całka (suma) wektora X, Y, Z w przedziale [from, to]
+    void AddIntegral(const Vectorcardiogram& vcg, int64_t from, int64_t to, double sum[3]) {
+        const int64_t last = static_cast<int64_t>(vcg.Size()) - 1;
+        from = std::max<int64_t>(0, from);
+        to = std::min(last, to);
+        for (int64_t k = from; k <= to; ++k) {
+            sum[0] += vcg.x[k];
+            sum[1] += vcg.y[k];
+            sum[2] += vcg.z[k];
+        }
+    }
+}
+
+Vectorcardiogram VectorcardiogramService::Derive(const std::vector<SignalDatapoint>& datapoints, int frequency,
+                                                 bool derived_limb_leads) {
+    Vectorcardiogram vcg;
+    vcg.frequency = frequency;
+    if (datapoints.empty()) return vcg;
+
+    const size_t expected_channels = derived_limb_leads
+                                         ? SignalDataset::INDEPENDENT_LEAD_COUNT
+                                         : SignalDataset::STANDARD_LEAD_COUNT;
+    if (datapoints.front().channelValues.size() != expected_channels) return vcg;
+
+    size_t channel[INPUT_LEADS];
+    for (size_t l = 0; l < INPUT_LEADS; ++l)
+        channel[l] = static_cast<size_t>(SignalDataset::StorageIndex(INPUT_ORDER[l], derived_limb_leads));
+
+    const size_t n = datapoints.size();
+    vcg.x.resize(n);
+    vcg.y.resize(n);
+    vcg.z.resize(n);
+    vcg.magnitude.resize(n);
+    float* outputs[3] = {vcg.x.data(), vcg.y.data(), vcg.z.data()};
+
+    ParallelForRange(n, PARALLEL_GRAIN, [&](size_t from, size_t to) {
+        float leads[INPUT_LEADS][BLOCK_SIZE];
+        for (size_t block = from; block < to; block += BLOCK_SIZE) {
+            const size_t count = std::min(BLOCK_SIZE, to - block);
+
+            // Transpozycja bloku: próbki wielokanałowe -> osiem ciągłych buforów odprowadzeń
+            for (size_t k = 0; k < count; ++k) {
+                const float* values = datapoints[block + k].channelValues.data();
+                for (size_t l = 0; l < INPUT_LEADS; ++l) leads[l][k] = values[channel[l]];
+            }
+
+            // out = M · leads, akumulacja po odprowadzeniach, pętla wewnętrzna po próbkach
+            for (size_t o = 0; o < 3; ++o) {
+                float* out = outputs[o] + block;
+                for (size_t k = 0; k < count; ++k) out[k] = INVERSE_DOWER[o][0] * leads[0][k];
+                for (size_t l = 1; l < INPUT_LEADS; ++l) {
+                    const float weight = INVERSE_DOWER[o][l];
+                    const float* in = leads[l];
+                    for (size_t k = 0; k < count; ++k) out[k] += weight * in[k];
+                }
+            }
+
+            const float* x = outputs[0] + block;
+            const float* y = outputs[1] + block;
+            const float* z = outputs[2] + block;
+            float* magnitude = vcg.magnitude.data() + block;
+            for (size_t k = 0; k < count; ++k)
+                magnitude[k] = std::sqrt(x[k] * x[k] + y[k] * y[k] + z[k] * z[k]);
+        }
+    });
+    return vcg;
+}
+
+double VectorcardiogramService::SpatialQRSTAngle(const Vectorcardiogram& vcg,
+                                                 const std::vector<BeatFiducials>& beats) {
+    double qrs[3] = {0.0, 0.0, 0.0};
+    double t[3] = {0.0, 0.0, 0.0};
+    size_t used = 0;
+    for (const BeatFiducials& beat : beats) {
+        if (!beat.HasTWave() || beat.qrs_onset == BeatFiducials::NONE || beat.qrs_offset == BeatFiducials::NONE)
+            continue;
+        AddIntegral(vcg, beat.qrs_onset, beat.qrs_offset, qrs);
+        AddIntegral(vcg, beat.t_onset, beat.t_offset, t);
+        ++used;
+    }
+    if (used == 0) return std::numeric_limits<double>::quiet_NaN();
+
+    const double dot = qrs[0] * t[0] + qrs[1] * t[1] + qrs[2] * t[2];
+    const double norms = std::sqrt(qrs[0] * qrs[0] + qrs[1] * qrs[1] + qrs[2] * qrs[2]) *
+                         std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2]);
+    if (norms <= 0.0) return std::numeric_limits<double>::quiet_NaN();
+    return std::acos(std::max(-1.0, std::min(1.0, dot / norms))) * 180.0 / M_PI;
+}
@@ -1,7 +1,164 @@
 #include "../../include/service/waves_detection_service.h"
+#include <algorithm>
+#include <cmath>
 
-std::vector<WaveAnnotatedSignalDatapoint> WavesDetectionService::Detect(const std::vector<SignalDatapoint> &datapoints,
-                                                                        int frequency) {
-    // TODO(Magda): trzeba uzupełnić
-    return std::vector<WaveAnnotatedSignalDatapoint>{};
+#include "../../include/util/parallel_for.h"
+
+namespace {
+    // Okna wyszukiwania względem piku R [s]
+    constexpr double QRS_SEARCH_BEFORE = 0.10;
+    constexpr double QRS_SEARCH_AFTER = 0.14;
+    constexpr double QRS_SLOPE_WINDOW = 0.06;
+    // Granica QRS: nachylenie spada poniżej tego ułamka największego nachylenia zespołu
+    constexpr double QRS_SLOPE_FRACTION = 0.1;
+    // Odcinek PQ przed początkiem QRS służący za linię izoelektryczną [s]
+    constexpr double BASELINE_WINDOW = 0.02;
+
+    // Okno załamka T: od końca QRS + T_START_DELAY do ułamka odstępu RR za pikiem R (nie dalej niż T_MAX_END)
+    constexpr double T_START_DELAY = 0.06;
+    constexpr double T_RR_FRACTION = 0.65;
+    constexpr double T_MAX_END = 0.60;
+
+    // Okno załamka P: do P_MAX_BEFORE przed początkiem QRS, kończy się P_END_GAP przed nim
+    constexpr double P_MAX_BEFORE = 0.25;
+    constexpr double P_END_GAP = 0.01;
+    // Minimalna amplituda załamka P względem amplitudy piku R (poniżej - brak załamka P)
+    constexpr double P_MIN_RELATIVE_AMPLITUDE = 0.04;
+
+    // Domyślny odstęp RR dla pierwszego i ostatniego uderzenia, gdy brak sąsiada [s]
+    constexpr double DEFAULT_RR = 0.8;
+
+    // Widok jednego odprowadzenia z obcięciem indeksów do zakresu sygnału
+    class LeadView {
+        const std::vector<SignalDatapoint>& datapoints_;
+        int lead_;
+        int64_t last_;
+
+    public:
+        LeadView(const std::vector<SignalDatapoint>& datapoints, int lead)
+            : datapoints_(datapoints), lead_(lead), last_(static_cast<int64_t>(datapoints.size()) - 1) {
+        }
+
+        int64_t Clamp(int64_t i) const { return std::min(last_, std::max<int64_t>(0, i)); }
+
+        double At(int64_t i) const { return datapoints_[Clamp(i)].channelValues[lead_]; }
+
+        // Pochodna centralna na próbkę
+        double Slope(int64_t i) const { return 0.5 * (At(i + 1) - At(i - 1)); }
+    };
+
+    // Indeks największej wartości |f(k)| w [from, to]
+    template<typename F>
+    int64_t ArgMaxAbs(int64_t from, int64_t to, F&& f) {
+        int64_t best = from;
+        double best_value = -1.0;
+        for (int64_t k = from; k <= to; ++k) {
+            const double v = std::fabs(f(k));
+            if (v > best_value) {
+                best_value = v;
+                best = k;
+            }
+        }
+        return best;
+    }
+
+    // Załamek (P lub T) w oknie [from, to]: szczyt to największe odchylenie od linii izoelektrycznej,
+    // początek i koniec - przecięcie stycznej w punkcie największego nachylenia zbocza z linią izoelektryczną
+    bool DelineateWave(const LeadView& x, int64_t from, int64_t to, double baseline, double min_amplitude,
+                       int64_t& onset, int64_t& peak, int64_t& offset) {
+        if (to - from < 4) return false;
+        peak = ArgMaxAbs(from, to, [&](int64_t k) { return x.At(k) - baseline; });
+        if (std::fabs(x.At(peak) - baseline) < min_amplitude) return false;
+
+        const int64_t rise = ArgMaxAbs(from, peak, [&](int64_t k) { return x.Slope(k); });
+        const double rise_slope = x.Slope(rise);
+        onset = from;
+        if (std::fabs(rise_slope) > 1e-9) {
+            const double shift = (x.At(rise) - baseline) / rise_slope;
+            onset = std::max(from, std::min(peak, rise - static_cast<int64_t>(std::lround(shift))));
+        }
+
+        const int64_t fall = ArgMaxAbs(peak, to, [&](int64_t k) { return x.Slope(k); });
+        const double fall_slope = x.Slope(fall);
+        offset = to;
+        if (std::fabs(fall_slope) > 1e-9) {
+            const double shift = (baseline - x.At(fall)) / fall_slope;
+            offset = std::max(peak, std::min(to, fall + static_cast<int64_t>(std::lround(shift))));
+        }
+        return true;
+    }
+
+    BeatFiducials DelineateBeat(const LeadView& x, int64_t r, int64_t rr_previous, int64_t rr_next, int frequency) {
+        BeatFiducials beat;
+        beat.r_peak = r;
+        auto samples = [frequency](double seconds) { return static_cast<int64_t>(std::lround(seconds * frequency)); };
+
+        // QRS - od zewnętrznych brzegów okna do środka, do pierwszej próbki o znaczącym nachyleniu
+        const int64_t qrs_from = x.Clamp(r - std::min(samples(QRS_SEARCH_BEFORE), rr_previous / 3));
+        const int64_t qrs_to = x.Clamp(r + std::min(samples(QRS_SEARCH_AFTER), rr_next / 3));
+        double max_slope = 0.0;
+        for (int64_t k = x.Clamp(r - samples(QRS_SLOPE_WINDOW)); k <= x.Clamp(r + samples(QRS_SLOPE_WINDOW)); ++k)
+            max_slope = std::max(max_slope, std::fabs(x.Slope(k)));
+        const double threshold = QRS_SLOPE_FRACTION * max_slope;
+
+        beat.qrs_onset = qrs_from;
+        while (beat.qrs_onset < r && std::fabs(x.Slope(beat.qrs_onset)) < threshold) ++beat.qrs_onset;
+        beat.qrs_offset = qrs_to;
+        while (beat.qrs_offset > r && std::fabs(x.Slope(beat.qrs_offset)) < threshold) --beat.qrs_offset;
+
+        double baseline = 0.0;
+        const int64_t baseline_from = x.Clamp(beat.qrs_onset - samples(BASELINE_WINDOW));
+        for (int64_t k = baseline_from; k <= beat.qrs_onset; ++k) baseline += x.At(k);
+        baseline /= static_cast<double>(beat.qrs_onset - baseline_from + 1);
+
+        // T - między końcem QRS a ułamkiem następnego odstępu RR
+        const int64_t t_from = x.Clamp(beat.qrs_offset + samples(T_START_DELAY));
+        const int64_t t_to = x.Clamp(r + std::min(samples(T_MAX_END), static_cast<int64_t>(T_RR_FRACTION * rr_next)));
+        int64_t onset, peak, offset;
+        if (DelineateWave(x, t_from, t_to, baseline, 0.0, onset, peak, offset)) {
+            beat.t_onset = std::max(onset, beat.qrs_offset);
+            beat.t_peak = peak;
+            beat.t_offset = offset;
+        }
+
+        // P - przed początkiem QRS, nie wcześniej niż w drugiej połowie poprzedniego odstępu RR
+        const int64_t p_from = x.Clamp(std::max(beat.qrs_onset - samples(P_MAX_BEFORE), r - rr_previous / 2));
+        const int64_t p_to = x.Clamp(beat.qrs_onset - samples(P_END_GAP));
+        const double min_p_amplitude = P_MIN_RELATIVE_AMPLITUDE * std::fabs(x.At(r) - baseline);
+        if (DelineateWave(x, p_from, p_to, baseline, min_p_amplitude, onset, peak, offset)) {
+            beat.p_onset = onset;
+            beat.p_peak = peak;
+            beat.p_offset = offset;
+        }
+
+        return beat;
+    }
+}
+
+WavesDetectionService::WavesDetectionService(int lead) : lead_(lead) {
+}
+
+std::vector<BeatFiducials> WavesDetectionService::Detect(
+    const std::vector<SignalDatapoint> &datapoints,
+    const std::vector<int64_t> &r_peaks,
+    int frequency) {
+    std::vector<BeatFiducials> beats(r_peaks.size());
+    if (datapoints.empty() || frequency <= 0 || static_cast<int>(datapoints[0].channelValues.size()) <= lead_)
+        return beats;
+
+    const LeadView x(datapoints, lead_);
+    const int64_t default_rr = static_cast<int64_t>(DEFAULT_RR * frequency);
+
+    // Każde uderzenie zależy tylko od swojego okna i sąsiednich pików R, więc uderzenia
+    // są niezależne i dzielone między wątki w paczkach
+    ParallelFor(r_peaks.size(), [&](size_t i) {
+        const int64_t r = r_peaks[i];
+        int64_t rr_previous = i > 0 ? r - r_peaks[i - 1] : 0;
+        int64_t rr_next = i + 1 < r_peaks.size() ? r_peaks[i + 1] - r : 0;
+        if (rr_previous <= 0) rr_previous = rr_next > 0 ? rr_next : default_rr;
+        if (rr_next <= 0) rr_next = rr_previous;
+        beats[i] = DelineateBeat(x, r, rr_previous, rr_next, frequency);
+    }, 512);
+
+    return beats;
 }